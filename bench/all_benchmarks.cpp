@@ -0,0 +1,6 @@
+#include <benchmark/benchmark.h>
+
+#include "board_bench.cpp"
+#include "player_bench.cpp"
+
+BENCHMARK_MAIN();
@@ -0,0 +1,125 @@
+#include "Board.hpp"
+#include "BitBoard.hpp"
+#include "FixedBoard.hpp"
+#include "positions.hpp"
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+static const size_t POSITIONS = 1024;
+static const uint64_t SEED = 42;
+
+//! Sizes every Board benchmark runs on, standard and large
+static void boardSizes(benchmark::internal::Benchmark* b) {
+	b->Args({ 7, 6 })->Args({ 12, 10 })->Args({ 20, 16 });
+}
+
+//! A put into a random legal column followed by the matching unput
+static void BM_BoardPutUnput(benchmark::State& state) {
+	std::vector<Position> pos = randomPositions(state.range(0), state.range(1), POSITIONS, SEED);
+	size_t i = 0;
+
+	for(auto _ : state) {
+		Position& p = pos[i++ % POSITIONS];
+		size_t x = p.board.legalMoves()[i % p.board.legalMoves().size()];
+
+		benchmark::DoNotOptimize(p.board.put(p.toMove, x));
+		p.board.unput(x);
+	}
+}
+BENCHMARK(BM_BoardPutUnput)->Apply(boardSizes);
+
+static void BM_CausedWin(benchmark::State& state) {
+	std::vector<Position> pos = randomPositions(state.range(0), state.range(1), POSITIONS, SEED);
+	size_t i = 0;
+
+	for(auto _ : state) {
+		const Position& p = pos[i++ % POSITIONS];
+		benchmark::DoNotOptimize(causedWin(p.board, p.lastX, p.lastY));
+	}
+}
+BENCHMARK(BM_CausedWin)->Apply(boardSizes);
+
+static void BM_Winner(benchmark::State& state) {
+	std::vector<Position> pos = randomPositions(state.range(0), state.range(1), POSITIONS, SEED);
+	size_t i = 0;
+
+	for(auto _ : state) {
+		benchmark::DoNotOptimize(pos[i++ % POSITIONS].board.winner());
+	}
+}
+BENCHMARK(BM_Winner)->Apply(boardSizes);
+
+static void BM_CanonicalHash(benchmark::State& state) {
+	std::vector<Position> pos = randomPositions(state.range(0), state.range(1), POSITIONS, SEED);
+	size_t i = 0;
+
+	for(auto _ : state) {
+		benchmark::DoNotOptimize(pos[i++ % POSITIONS].board.canonicalHash());
+	}
+}
+BENCHMARK(BM_CanonicalHash)->Apply(boardSizes);
+
+//! A key built from every cell, what callers had to do without hash()
+static void BM_ScanKey(benchmark::State& state) {
+	std::vector<Position> pos = randomPositions(state.range(0), state.range(1), POSITIONS, SEED);
+	size_t i = 0;
+
+	for(auto _ : state) {
+		const Board& b = pos[i++ % POSITIONS].board;
+		uint64_t k = 0;
+		for(size_t x = 0; x < b.width(); x++) {
+			for(size_t y = 0; y < b.height(); y++) {
+				k = k * 3 + uint64_t(b(x, y));
+			}
+		}
+		benchmark::DoNotOptimize(k);
+	}
+}
+BENCHMARK(BM_ScanKey)->Apply(boardSizes);
+
+//! Copy-assigning into a scratch board, like resetting a board before
+//! every playout
+static void BM_BoardCopyAssign(benchmark::State& state) {
+	std::vector<Position> pos = randomPositions(state.range(0), state.range(1), POSITIONS, SEED);
+	Board dst(state.range(0), state.range(1));
+	size_t i = 0;
+
+	for(auto _ : state) {
+		dst = pos[i++ % POSITIONS].board;
+		benchmark::DoNotOptimize(dst);
+	}
+}
+BENCHMARK(BM_BoardCopyAssign)->Apply(boardSizes);
+
+//! Copy-constructing, like the per root move copy in makeMove
+static void BM_BoardCopyConstruct(benchmark::State& state) {
+	std::vector<Position> pos = randomPositions(state.range(0), state.range(1), POSITIONS, SEED);
+	size_t i = 0;
+
+	for(auto _ : state) {
+		Board copy(pos[i++ % POSITIONS].board);
+		benchmark::DoNotOptimize(copy);
+	}
+}
+BENCHMARK(BM_BoardCopyConstruct)->Apply(boardSizes);
+
+//! The same copies for the fixed size representations, 7x6 only
+template<class B>
+static void BM_CopyAssign(benchmark::State& state) {
+	std::vector<Position> pos = randomPositions(7, 6, POSITIONS, SEED);
+	std::vector<B> boards;
+	for(const Position& p : pos) {
+		boards.push_back(B(p.board));
+	}
+
+	B dst(boards[0]);
+	size_t i = 0;
+
+	for(auto _ : state) {
+		dst = boards[i++ % POSITIONS];
+		benchmark::DoNotOptimize(dst);
+	}
+}
+BENCHMARK_TEMPLATE(BM_CopyAssign, FixedBoard<7, 6>);
+BENCHMARK_TEMPLATE(BM_CopyAssign, BitBoard);
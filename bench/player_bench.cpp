@@ -0,0 +1,153 @@
+#include "BatchRollout.hpp"
+#include "BitBoard.hpp"
+#include "Board.hpp"
+#include "FixedBoard.hpp"
+#include "HybridPlayer.hpp"
+#include "MonteCarloPlayer.hpp"
+#include "Random.hpp"
+#include "Rollout.hpp"
+#include "positions.hpp"
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+//! One rollout on a Board from a random position, items are playouts
+static void BM_BoardRollout(benchmark::State& state) {
+	std::vector<Position> pos = randomPositions(state.range(0), state.range(1), 256, 7);
+	Board sim(state.range(0), state.range(1));
+	XorShift g(1);
+	size_t i = 0;
+
+	for(auto _ : state) {
+		const Position& p = pos[i++ % pos.size()];
+		sim = p.board;
+		benchmark::DoNotOptimize(rollout(sim, p.toMove, g));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BoardRollout)->Args({ 7, 6 })->Args({ 12, 10 });
+
+static void BM_BitBoardRollout(benchmark::State& state) {
+	BitBoard start(7, 6);
+	XorShift g(1);
+
+	for(auto _ : state) {
+		BitBoard sim(start);
+		benchmark::DoNotOptimize(rollout(sim, Board::Player::P1, g));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BitBoardRollout);
+
+//! Same with TacticalRollout
+static void BM_TacticalRollout(benchmark::State& state) {
+	BitBoard start(7, 6);
+	TacticalRollout policy(start);
+	XorShift g(1);
+
+	for(auto _ : state) {
+		BitBoard sim(start);
+		benchmark::DoNotOptimize(policy(sim, Board::Player::P1, g));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TacticalRollout);
+
+//! 64 rollouts from a random 9x7 position, too big for a BitBoard, on
+//! the Board itself (0), through boardRollouts, which plays on a
+//! BasicWideBitBoard (1), or on a FixedBoard (2). Items are playouts.
+static void BM_BoardRollouts9x7(benchmark::State& state) {
+	const size_t games = 64;
+	std::vector<Position> pos = randomPositions(9, 7, 256, 7);
+	XorShift g(1);
+	size_t i = 0;
+
+	for(auto _ : state) {
+		const Position& p = pos[i++ % pos.size()];
+		if(state.range(0) == 2) {
+			benchmark::DoNotOptimize(rollouts(FixedBoard<9, 7>(p.board), p.toMove, p.toMove, games, g));
+		} else {
+			benchmark::DoNotOptimize(state.range(0) ? boardRollouts(p.board, p.toMove, p.toMove, games, g) :
+			                                          rollouts(p.board, p.toMove, p.toMove, games, g));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * games);
+}
+BENCHMARK(BM_BoardRollouts9x7)->Arg(0)->Arg(1)->Arg(2);
+
+//! 64 playouts per iteration on big boards, on Board (0) or on a
+//! BasicWideBitBoard (1)
+static void BM_WideRollouts(benchmark::State& state) {
+	const size_t games = 64;
+	std::vector<Position> pos = randomPositions(state.range(0), state.range(1), 256, 9);
+	XorShift g(1);
+	size_t i = 0;
+
+	for(auto _ : state) {
+		const Position& p = pos[i++ % pos.size()];
+		benchmark::DoNotOptimize(state.range(2) ? boardRollouts(p.board, p.toMove, p.toMove, games, g) :
+		                                          rollouts(p.board, p.toMove, p.toMove, games, g));
+	}
+	state.SetItemsProcessed(state.iterations() * games);
+}
+BENCHMARK(BM_WideRollouts)->Args({12, 10, 0})->Args({12, 10, 1})->Args({16, 12, 0})->Args({16, 12, 1});
+
+//! 1024 playouts per iteration on the given Simd level, skipped if the
+//! CPU lacks it
+static void BM_BatchRollouts(benchmark::State& state) {
+	Simd simd = Simd(state.range(0));
+	if(simd > bestSimd()) {
+		state.SkipWithError("not supported on this CPU");
+		return;
+	}
+
+	BitBoard start(7, 6);
+	XorShift g(1);
+
+	for(auto _ : state) {
+		benchmark::DoNotOptimize(batchRollouts(start, Board::Player::P1, Board::Player::P1, 1024, g, simd));
+	}
+	state.SetItemsProcessed(state.iterations() * 1024);
+}
+BENCHMARK(BM_BatchRollouts)->Arg(int(Simd::SCALAR))->Arg(int(Simd::AVX2))->Arg(int(Simd::AVX512));
+
+//! A whole MonteCarloPlayer move with all of its 20000 games from seeded
+//! positions, items are playouts
+static void BM_MonteCarloMove(benchmark::State& state) {
+	const size_t games = 20000;
+	std::vector<Position> pos = randomPositions(state.range(0), state.range(1), 64, 3);
+	MonteCarloPlayer player(games);
+	player.setSolverThreshold(0);
+	player.setEarlyStop(0);
+	size_t i = 0;
+
+	for(auto _ : state) {
+		const Position& p = pos[i++ % pos.size()];
+		benchmark::DoNotOptimize(player.makeMove(p.board, p.toMove));
+	}
+	state.SetItemsProcessed(state.iterations() * games);
+}
+BENCHMARK(BM_MonteCarloMove)->Args({ 7, 6 })->Args({ 12, 10 })->Unit(benchmark::kMillisecond);
+
+//! A HybridPlayer move that is all minimax, no rollouts, from seeded
+//! positions, with leaves scored by the Evaluator if the last argument
+//! is 1. Every move starts with a cold table. Items are minimax nodes.
+static void BM_HybridMinimax(benchmark::State& state) {
+	std::vector<Position> pos = randomPositions(state.range(0), state.range(1), 64, 3);
+	size_t i = 0;
+	uint64_t nodes = 0;
+
+	for(auto _ : state) {
+		state.PauseTiming();
+		HybridPlayer player(0, state.range(2), 1);
+		player.setSolverThreshold(0);
+		player.setEvaluation(state.range(3) != 0);
+		state.ResumeTiming();
+
+		const Position& p = pos[i++ % pos.size()];
+		benchmark::DoNotOptimize(player.makeMove(p.board, p.toMove));
+		nodes += player.lastStats()->counters.nodes;
+	}
+	state.SetItemsProcessed(nodes);
+}
+BENCHMARK(BM_HybridMinimax)->Args({ 7, 6, 7, 0 })->Args({ 12, 10, 5, 0 })->Args({ 7, 6, 7, 1 })->Unit(benchmark::kMillisecond)->UseRealTime();
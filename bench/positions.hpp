@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Board.hpp"
+#include "Random.hpp"
+
+#include <vector>
+
+//! A position from a random game and the move that led to it
+struct Position {
+	Board board;
+	size_t lastX;
+	size_t lastY;
+	//player to move next
+	Board::Player toMove;
+};
+
+//! count positions from seeded random games of at least one move, none
+//! of them over
+static std::vector<Position> randomPositions(size_t width, size_t height, size_t count, uint64_t seed) {
+	XorShift g(seed);
+	std::vector<Position> positions;
+
+	while(positions.size() < count) {
+		Board b(width, height);
+		Board::Player p = Board::Player::P1;
+		size_t plies = 1 + g.below(width * height / 2);
+
+		for(size_t i = 0; i < plies; i++) {
+			size_t x = b.legalMoves()[g.below(b.legalMoves().size())];
+			size_t y = b.put(p, x);
+			p = p == Board::Player::P1 ? Board::Player::P2 : Board::Player::P1;
+
+			if(b.isGameOver()) {
+				break;
+			}
+			if(i + 1 == plies) {
+				positions.push_back({ b, x, y, p });
+			}
+		}
+	}
+
+	return positions;
+}
@@ -0,0 +1,349 @@
+#include "AnalysisServer.hpp"
+#include "BitBoard.hpp"
+#include "Board.hpp"
+#include "HybridPlayer.hpp"
+#include "OpeningBook.hpp"
+#include "SearchStats.hpp"
+#include "ThreadPool.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+//! Column of a move character, or -1
+static int column(char c) {
+	return c >= '0' && c <= '9' ? c - '0' :
+	       c >= 'a' && c <= 'z' ? c - 'a' + 10 :
+	                              -1;
+}
+
+static std::string reply(const std::string& id, size_t move, float score, const char* source) {
+	char buf[64];
+	std::snprintf(buf, sizeof(buf), " %zu %.3f %s", move, score, source);
+	return id + buf;
+}
+
+//! The ID of a request line, ? if it has none
+static std::string requestId(const std::string& line) {
+	std::istringstream in(line);
+	std::string id;
+	in >> id;
+	return id.empty() ? "?" : id;
+}
+
+AnalysisServer::AnalysisServer(const std::string& bookPath, size_t ttMegabytes)
+	: _book(), _ttMegabytes(ttMegabytes), _stop(false)
+{
+	if(!bookPath.empty()) {
+		_book.reset(new OpeningBook(bookPath));
+	}
+
+	_dispatcher = std::thread(&AnalysisServer::dispatch, this);
+}
+
+AnalysisServer::~AnalysisServer() {
+	{
+		std::lock_guard<std::mutex> lock(_queueM);
+		_stop = true;
+	}
+	_queued.notify_all();
+	_dispatcher.join();
+}
+
+std::unique_ptr<HybridPlayer> AnalysisServer::acquire(size_t width, size_t height) {
+	std::lock_guard<std::mutex> lock(_idleM);
+	if(_idle.empty()) {
+		//the budget is set for each request
+		return std::unique_ptr<HybridPlayer>(new HybridPlayer(std::chrono::milliseconds(1), _ttMegabytes));
+	}
+
+	//a table warm for this size is worth the most. One from another
+	//size is still safe, the board hash covers the size so its entries
+	//are never read here and just age out.
+	size_t pick = _idle.size() - 1;
+	for(size_t i = 0; i < _idle.size(); i++) {
+		if(_idle[i].width == width && _idle[i].height == height) {
+			pick = i;
+		}
+	}
+
+	std::unique_ptr<HybridPlayer> s = std::move(_idle[pick].searcher);
+	_idle.erase(_idle.begin() + pick);
+	return s;
+}
+
+void AnalysisServer::release(size_t width, size_t height, std::unique_ptr<HybridPlayer> s) {
+	std::lock_guard<std::mutex> lock(_idleM);
+	_idle.push_back({ width, height, std::move(s) });
+}
+
+std::string AnalysisServer::handle(const std::string& line) {
+	std::istringstream in(line);
+	std::string id, size, moves, ms, rest;
+	in >> id >> size >> moves >> ms;
+	if(id.empty()) {
+		return "? error empty request";
+	}
+	if(ms.empty() || (in >> rest)) {
+		return id + " error expected ID WxH MOVES MS";
+	}
+
+	size_t x = size.find('x');
+	char* end;
+	unsigned long width = std::strtoul(size.c_str(), &end, 10);
+	if(x == std::string::npos || end != size.c_str() + x) {
+		return id + " error bad board size";
+	}
+	unsigned long height = std::strtoul(size.c_str() + x + 1, &end, 10);
+	if(*end || width < 1 || width > 36 || height < 1 || height > 64) {
+		return id + " error bad board size";
+	}
+
+	long budget = std::strtol(ms.c_str(), &end, 10);
+	if(*end || budget <= 0) {
+		return id + " error bad time budget";
+	}
+
+	Board b(width, height);
+	Board::Player p = Board::Player::P1;
+	if(moves != "-") {
+		for(char c : moves) {
+			int col = column(c);
+			if(col < 0 || size_t(col) >= width || b.isColumnFull(col) || b.isGameOver()) {
+				return id + " error illegal move " + c;
+			}
+
+			b.put(p, col);
+			p = p == Board::Player::P1 ? Board::Player::P2 : Board::Player::P1;
+		}
+	}
+	if(b.isGameOver()) {
+		return id + " error game over";
+	}
+
+	if(_book && b.width() == _book->width() && b.height() == _book->height()) {
+		size_t move;
+		int score;
+		if(_book->lookup(BitBoard(b), p, move, score) && move < b.width() && !b.isColumnFull(move)) {
+			float s = score == OpeningBook::UNKNOWN_SCORE ? 0 : score > 0 ? 1 : score < 0 ? -1 : 0;
+			return reply(id, move, s, "book");
+		}
+	}
+
+	//building a new searcher can throw too
+	std::unique_ptr<HybridPlayer> s;
+	std::string r;
+	try {
+		s = acquire(width, height);
+		s->setBudget(std::chrono::milliseconds(budget));
+		size_t move = s->makeMove(b, p);
+		const SearchStats& stats = *s->lastStats();
+		r = reply(id, move, stats.score, stats.solved ? "solver" : "search");
+	} catch(const std::exception& e) {
+		r = id + " error " + e.what();
+	}
+	if(s) {
+		release(width, height, std::move(s));
+	}
+
+	return r;
+}
+
+std::vector<std::string> AnalysisServer::handle(const std::vector<std::string>& lines) {
+	std::vector<std::string> replies(lines.size());
+
+	if(lines.size() == 1) {
+		//alone, the search can spread over the pool itself
+		replies[0] = handle(lines[0]);
+	} else {
+		//searches started from a pool task run on that task's thread
+		ThreadPool::shared().parallelFor(lines.size(), [&](size_t i) {
+			replies[i] = handle(lines[i]);
+		});
+	}
+
+	return replies;
+}
+
+std::future<std::string> AnalysisServer::submit(const std::string& line) {
+	std::unique_ptr<Request> r(new Request());
+	r->line = line;
+	std::future<std::string> f = r->reply.get_future();
+
+	{
+		std::lock_guard<std::mutex> lock(_queueM);
+		_queue.push_back(std::move(r));
+	}
+	_queued.notify_one();
+
+	return f;
+}
+
+void AnalysisServer::dispatch() {
+	for(;;) {
+		std::vector<std::unique_ptr<Request>> batch;
+		{
+			std::unique_lock<std::mutex> lock(_queueM);
+			_queued.wait(lock, [this]() { return _stop || !_queue.empty(); });
+			if(_queue.empty()) {
+				return;
+			}
+			batch.swap(_queue);
+		}
+
+		std::vector<std::string> lines;
+		for(const auto& r : batch) {
+			lines.push_back(r->line);
+		}
+
+		//nothing may escape this thread, every request gets an answer
+		std::vector<std::string> replies;
+		try {
+			replies = handle(lines);
+		} catch(const std::exception& e) {
+			replies.clear();
+			for(const std::string& l : lines) {
+				replies.push_back(requestId(l) + " error " + e.what());
+			}
+		}
+
+		for(size_t i = 0; i < batch.size(); i++) {
+			batch[i]->reply.set_value(replies[i]);
+		}
+	}
+}
+
+void AnalysisServer::serve(std::istream& in, std::ostream& out) {
+	std::mutex m;
+	std::condition_variable cv;
+	std::deque<std::future<std::string>> pending;
+	bool done = false;
+
+	//answers go out in order while more requests are read
+	std::thread writer([&]() {
+		for(;;) {
+			std::future<std::string> f;
+			{
+				std::unique_lock<std::mutex> lock(m);
+				cv.wait(lock, [&]() { return done || !pending.empty(); });
+				if(pending.empty()) {
+					return;
+				}
+				f = std::move(pending.front());
+				pending.pop_front();
+			}
+
+			out << f.get() << std::endl;
+		}
+	});
+
+	std::string line;
+	while(std::getline(in, line)) {
+		if(line.find_first_not_of(" \t\r") == std::string::npos) {
+			continue;
+		}
+
+		std::lock_guard<std::mutex> lock(m);
+		pending.push_back(submit(line));
+		cv.notify_one();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m);
+		done = true;
+	}
+	cv.notify_one();
+	writer.join();
+}
+
+#ifndef _WIN32
+
+void AnalysisServer::connection(int fd) {
+	std::string buffer;
+	char chunk[4096];
+
+	ssize_t n;
+	while((n = read(fd, chunk, sizeof(chunk))) > 0) {
+		buffer.append(chunk, n);
+
+		size_t start = 0;
+		for(size_t nl; (nl = buffer.find('\n', start)) != std::string::npos; start = nl + 1) {
+			std::string line = buffer.substr(start, nl - start);
+			if(line.find_first_not_of(" \t\r") == std::string::npos) {
+				continue;
+			}
+
+			std::string r = submit(line).get() + "\n";
+			for(size_t sent = 0; sent < r.size();) {
+				//no SIGPIPE if the client went away
+				ssize_t w = send(fd, r.data() + sent, r.size() - sent, MSG_NOSIGNAL);
+				if(w <= 0) {
+					close(fd);
+					return;
+				}
+				sent += w;
+			}
+		}
+		buffer.erase(0, start);
+	}
+
+	close(fd);
+}
+
+void AnalysisServer::listen(const std::string& path) {
+	sockaddr_un addr = sockaddr_un();
+	addr.sun_family = AF_UNIX;
+	if(path.size() >= sizeof(addr.sun_path)) {
+		throw std::runtime_error("Socket path too long: " + path);
+	}
+	path.copy(addr.sun_path, path.size());
+
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if(fd < 0) {
+		throw std::runtime_error("Can't create socket");
+	}
+
+	//a stale socket from an earlier run
+	unlink(path.c_str());
+	if(bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(fd, 64) != 0) {
+		close(fd);
+		throw std::runtime_error("Can't listen on " + path);
+	}
+
+	for(;;) {
+		int client = accept(fd, nullptr, nullptr);
+		if(client < 0) {
+			if(errno == EINTR) {
+				continue;
+			}
+			close(fd);
+			throw std::runtime_error("Failed accepting on " + path);
+		}
+
+		std::thread(&AnalysisServer::connection, this, client).detach();
+	}
+}
+
+#else
+
+void AnalysisServer::connection(int) {}
+
+void AnalysisServer::listen(const std::string&) {
+	throw std::runtime_error("Unix domain sockets aren't available here");
+}
+
+#endif
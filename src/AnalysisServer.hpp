@@ -0,0 +1,91 @@
+#pragma once
+
+#include "HybridPlayer.hpp"
+#include "OpeningBook.hpp"
+
+#include <condition_variable>
+#include <future>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//! Long running position analysis with warm state. Searchers (and their
+//! transposition tables), the opening book and the shared thread pool
+//! are kept between requests.
+//!
+//! Line protocol, one request per line:
+//!   ID WxH MOVES MS
+//! MOVES are the columns played so far from the empty board, one
+//! character each (0-9 then a-z), or - for the empty board. The side to
+//! move follows from their count. MS is the time budget. The answer is
+//!   ID MOVE SCORE SOURCE
+//! with the best column, its value for the side to move between -1 and 1
+//! and where it came from: book, solver or search. Bad requests get
+//!   ID error MESSAGE
+//!
+//! Requests that arrive while others are being searched are batched and
+//! searched side by side on the shared pool, one thread each. A request
+//! that arrives alone gets the whole pool.
+class AnalysisServer {
+public:
+	//! bookPath may be empty. Throws std::runtime_error if the book
+	//! can't be read.
+	explicit AnalysisServer(const std::string& bookPath = "", size_t ttMegabytes = 16);
+	~AnalysisServer();
+
+	AnalysisServer(const AnalysisServer&) = delete;
+	AnalysisServer& operator=(const AnalysisServer&) = delete;
+
+	//! Answers one request line
+	std::string handle(const std::string& line);
+
+	//! Answers a batch of request lines, in order
+	std::vector<std::string> handle(const std::vector<std::string>& lines);
+
+	//! Queues a request to be answered with whatever else is queued.
+	//! Safe to call from any thread.
+	std::future<std::string> submit(const std::string& line);
+
+	//! Answers requests from in on out, in order, until in ends. Lines
+	//! are read ahead so that requests sent together get batched.
+	void serve(std::istream& in, std::ostream& out);
+
+	//! Serves every connection to a Unix domain socket at path. Only
+	//! returns by throwing std::runtime_error.
+	void listen(const std::string& path);
+
+private:
+	struct Request {
+		std::string line;
+		std::promise<std::string> reply;
+	};
+
+	//! A searcher that last searched a width x height board if one is
+	//! idle, any idle one otherwise, or a new one
+	std::unique_ptr<HybridPlayer> acquire(size_t width, size_t height);
+	void release(size_t width, size_t height, std::unique_ptr<HybridPlayer> s);
+	void dispatch();
+	void connection(int fd);
+
+	std::unique_ptr<OpeningBook> _book;
+	size_t _ttMegabytes;
+
+	struct Idle {
+		size_t width;
+		size_t height;
+		std::unique_ptr<HybridPlayer> searcher;
+	};
+
+	//searchers not in use right now, with the size they last searched
+	std::mutex _idleM;
+	std::vector<Idle> _idle;
+
+	std::mutex _queueM;
+	std::condition_variable _queued;
+	std::vector<std::unique_ptr<Request>> _queue;
+	bool _stop;
+	std::thread _dispatcher;
+};
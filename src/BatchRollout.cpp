@@ -0,0 +1,319 @@
+#include "BatchRollout.hpp"
+#include "BitBoard.hpp"
+#include "Bits.hpp"
+#include "Board.hpp"
+#include "Random.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define C4_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const size_t LANES = 16;
+
+//! Constants of the board being played on
+struct Params {
+	uint64_t bottom;
+	uint64_t playable;
+	//cells of column 0
+	uint64_t column;
+	//height + 1
+	uint64_t stride;
+	uint64_t width;
+	uint64_t dirs[4];
+};
+
+//! One game per lane. cur holds the pieces of the player to move,
+//! moverIsP is all ones when that's the player the counts are for.
+//! Each lane has its own xorshift64 state.
+struct alignas(64) Lanes {
+	uint64_t cur[LANES];
+	uint64_t mask[LANES];
+	uint64_t rng[LANES];
+	uint64_t moverIsP[LANES];
+};
+
+//! Lanes whose game ended in the last step
+struct Done {
+	uint32_t win;
+	uint32_t loss;
+	uint32_t draw;
+};
+
+//Every step must match stepScalar exactly, lane for lane: advance the
+//lane's generator, pick column (rng >> 32) * width >> 32, play the next
+//free cell of it if there is one, then check for four and a full board.
+//Inactive lanes and lanes that picked a full column only advance their
+//generator.
+
+Done stepScalar(Lanes& s, const Params& k, uint32_t active) {
+	Done d = { 0, 0, 0 };
+
+	for(size_t i = 0; i < LANES; i++) {
+		uint64_t x = s.rng[i];
+		x ^= x >> 12;
+		x ^= x << 25;
+		x ^= x >> 27;
+		s.rng[i] = x;
+
+		uint64_t col  = ((x >> 32) * k.width) >> 32;
+		uint64_t cell = (s.mask[i] + k.bottom) & (k.column << (col * k.stride));
+		if(!(active >> i & 1) || !cell) {
+			continue;
+		}
+
+		uint64_t m = s.mask[i] | cell;
+		uint64_t c = s.cur[i] | cell;
+
+		uint64_t four = 0;
+		for(uint64_t dir : k.dirs) {
+			uint64_t t = c & (c >> dir);
+			four |= t & (t >> 2 * dir);
+		}
+
+		if(four) {
+			(s.moverIsP[i] ? d.win : d.loss) |= 1u << i;
+		} else if(m == k.playable) {
+			d.draw |= 1u << i;
+		} else {
+			s.cur[i] = c ^ m;
+			s.mask[i] = m;
+			s.moverIsP[i] = ~s.moverIsP[i];
+		}
+	}
+
+	return d;
+}
+
+#ifdef C4_X86_SIMD
+
+__attribute__((target("avx2")))
+Done stepAvx2(Lanes& s, const Params& k, uint32_t active) {
+	const __m256i zero     = _mm256_setzero_si256();
+	const __m256i bottom   = _mm256_set1_epi64x(k.bottom);
+	const __m256i playable = _mm256_set1_epi64x(k.playable);
+	const __m256i column   = _mm256_set1_epi64x(k.column);
+	const __m256i stride   = _mm256_set1_epi64x(k.stride);
+	const __m256i width    = _mm256_set1_epi64x(k.width);
+	const __m256i laneBits = _mm256_set_epi64x(8, 4, 2, 1);
+
+	__m128i sh[4], sh2[4];
+	for(int j = 0; j < 4; j++) {
+		sh[j]  = _mm_cvtsi32_si128(int(k.dirs[j]));
+		sh2[j] = _mm_cvtsi32_si128(int(2 * k.dirs[j]));
+	}
+
+	Done d = { 0, 0, 0 };
+
+	for(size_t v = 0; v < LANES; v += 4) {
+		__m256i* rp = reinterpret_cast<__m256i*>(s.rng + v);
+		__m256i* cp = reinterpret_cast<__m256i*>(s.cur + v);
+		__m256i* mp = reinterpret_cast<__m256i*>(s.mask + v);
+		__m256i* pp = reinterpret_cast<__m256i*>(s.moverIsP + v);
+
+		__m256i x = _mm256_load_si256(rp);
+		x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 12));
+		x = _mm256_xor_si256(x, _mm256_slli_epi64(x, 25));
+		x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 27));
+		_mm256_store_si256(rp, x);
+
+		__m256i col  = _mm256_srli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(x, 32), width), 32);
+		__m256i mask = _mm256_load_si256(mp);
+		__m256i cur  = _mm256_load_si256(cp);
+		__m256i cell = _mm256_and_si256(_mm256_add_epi64(mask, bottom),
+		                                _mm256_sllv_epi64(column, _mm256_mul_epu32(col, stride)));
+
+		__m256i m = _mm256_or_si256(mask, cell);
+		__m256i c = _mm256_or_si256(cur, cell);
+
+		__m256i four = zero;
+		for(int j = 0; j < 4; j++) {
+			__m256i t = _mm256_and_si256(c, _mm256_srl_epi64(c, sh[j]));
+			four = _mm256_or_si256(four, _mm256_and_si256(t, _mm256_srl_epi64(t, sh2[j])));
+		}
+
+		__m256i act   = _mm256_cmpeq_epi64(_mm256_and_si256(_mm256_set1_epi64x(active >> v), laneBits), laneBits);
+		__m256i moved = _mm256_andnot_si256(_mm256_cmpeq_epi64(cell, zero), act);
+		__m256i won   = _mm256_andnot_si256(_mm256_cmpeq_epi64(four, zero), moved);
+		__m256i full  = _mm256_andnot_si256(won, _mm256_and_si256(_mm256_cmpeq_epi64(m, playable), moved));
+		__m256i go    = _mm256_andnot_si256(_mm256_or_si256(won, full), moved);
+		__m256i mover = _mm256_load_si256(pp);
+
+		uint32_t wonBits  = _mm256_movemask_pd(_mm256_castsi256_pd(won));
+		uint32_t mineBits = _mm256_movemask_pd(_mm256_castsi256_pd(mover));
+		d.win  |= (wonBits & mineBits) << v;
+		d.loss |= (wonBits & ~mineBits) << v;
+		d.draw |= uint32_t(_mm256_movemask_pd(_mm256_castsi256_pd(full))) << v;
+
+		_mm256_store_si256(cp, _mm256_blendv_epi8(cur, _mm256_xor_si256(c, m), go));
+		_mm256_store_si256(mp, _mm256_blendv_epi8(mask, m, go));
+		_mm256_store_si256(pp, _mm256_xor_si256(mover, go));
+	}
+
+	return d;
+}
+
+//gcc 12 warns about the deliberately undefined vectors inside its own
+//avx512 intrinsics
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+
+__attribute__((target("avx512f")))
+Done stepAvx512(Lanes& s, const Params& k, uint32_t active) {
+	const __m512i bottom   = _mm512_set1_epi64(k.bottom);
+	const __m512i playable = _mm512_set1_epi64(k.playable);
+	const __m512i column   = _mm512_set1_epi64(k.column);
+	const __m512i stride   = _mm512_set1_epi64(k.stride);
+	const __m512i width    = _mm512_set1_epi64(k.width);
+	const __m512i ones     = _mm512_set1_epi64(-1);
+
+	__m128i sh[4], sh2[4];
+	for(int j = 0; j < 4; j++) {
+		sh[j]  = _mm_cvtsi32_si128(int(k.dirs[j]));
+		sh2[j] = _mm_cvtsi32_si128(int(2 * k.dirs[j]));
+	}
+
+	Done d = { 0, 0, 0 };
+
+	for(size_t v = 0; v < LANES; v += 8) {
+		__m512i x = _mm512_load_si512(s.rng + v);
+		x = _mm512_xor_si512(x, _mm512_srli_epi64(x, 12));
+		x = _mm512_xor_si512(x, _mm512_slli_epi64(x, 25));
+		x = _mm512_xor_si512(x, _mm512_srli_epi64(x, 27));
+		_mm512_store_si512(s.rng + v, x);
+
+		__m512i col  = _mm512_srli_epi64(_mm512_mul_epu32(_mm512_srli_epi64(x, 32), width), 32);
+		__m512i mask = _mm512_load_si512(s.mask + v);
+		__m512i cur  = _mm512_load_si512(s.cur + v);
+		__m512i cell = _mm512_and_si512(_mm512_add_epi64(mask, bottom),
+		                                _mm512_sllv_epi64(column, _mm512_mul_epu32(col, stride)));
+
+		__m512i m = _mm512_or_si512(mask, cell);
+		__m512i c = _mm512_or_si512(cur, cell);
+
+		__m512i four = _mm512_setzero_si512();
+		for(int j = 0; j < 4; j++) {
+			__m512i t = _mm512_and_si512(c, _mm512_srl_epi64(c, sh[j]));
+			four = _mm512_or_si512(four, _mm512_and_si512(t, _mm512_srl_epi64(t, sh2[j])));
+		}
+
+		__m512i mover = _mm512_load_si512(s.moverIsP + v);
+
+		__mmask8 moved = _mm512_mask_test_epi64_mask(__mmask8(active >> v), cell, cell);
+		__mmask8 won   = _mm512_mask_test_epi64_mask(moved, four, four);
+		__mmask8 full  = _mm512_mask_cmpeq_epi64_mask(moved & ~won, m, playable);
+		__mmask8 mine  = _mm512_test_epi64_mask(mover, mover);
+		__mmask8 go    = moved & ~won & ~full;
+
+		d.win  |= uint32_t(won & mine) << v;
+		d.loss |= uint32_t(won & ~mine & 0xFF) << v;
+		d.draw |= uint32_t(full) << v;
+
+		_mm512_store_si512(s.cur + v, _mm512_mask_mov_epi64(cur, go, _mm512_xor_si512(c, m)));
+		_mm512_store_si512(s.mask + v, _mm512_mask_mov_epi64(mask, go, m));
+		_mm512_store_si512(s.moverIsP + v, _mm512_mask_xor_epi64(mover, go, mover, ones));
+	}
+
+	return d;
+}
+
+#pragma GCC diagnostic pop
+
+#endif
+
+}
+
+Simd bestSimd() {
+#ifdef C4_X86_SIMD
+	static const Simd best = __builtin_cpu_supports("avx512f") ? Simd::AVX512 :
+	                         __builtin_cpu_supports("avx2")    ? Simd::AVX2 :
+	                                                             Simd::SCALAR;
+	return best;
+#else
+	return Simd::SCALAR;
+#endif
+}
+
+RolloutCounts batchRollouts(const BitBoard& b, Board::Player p, Board::Player toMove, size_t games, XorShift& g, Simd simd) {
+	assert(toMove != Board::Player::E);
+	assert(!b.isGameOver());
+	assert(b.winLength() == 4);
+
+	const uint64_t h = b.height();
+	Params k;
+	k.bottom = 0;
+	k.playable = 0;
+	k.column = (uint64_t(1) << h) - 1;
+	k.stride = h + 1;
+	k.width = b.width();
+	for(size_t x = 0; x < b.width(); x++) {
+		k.bottom   |= uint64_t(1) << (x * k.stride);
+		k.playable |= k.column << (x * k.stride);
+	}
+	k.dirs[0] = 1;
+	k.dirs[1] = h;
+	k.dirs[2] = h + 1;
+	k.dirs[3] = h + 2;
+
+	Lanes s;
+	for(size_t i = 0; i < LANES; i++) {
+		s.rng[i] = g() | 1;
+	}
+
+	RolloutCounts r = { 0, 0, 0 };
+	size_t started = 0;
+	uint32_t active = 0;
+
+	auto start = [&](size_t i) {
+		s.cur[i] = b.pieces(toMove);
+		s.mask[i] = b.mask();
+		s.moverIsP[i] = toMove == p ? ~uint64_t(0) : 0;
+		active |= 1u << i;
+		started++;
+	};
+
+	for(size_t i = 0; i < LANES && started < games; i++) {
+		start(i);
+	}
+
+	simd = std::min(simd, bestSimd());
+
+	while(active) {
+		Done d;
+		switch(simd) {
+#ifdef C4_X86_SIMD
+		case Simd::AVX512:
+			d = stepAvx512(s, k, active);
+			break;
+		case Simd::AVX2:
+			d = stepAvx2(s, k, active);
+			break;
+#endif
+		default:
+			d = stepScalar(s, k, active);
+			break;
+		}
+
+		r.wins   += popcount64(d.win);
+		r.losses += popcount64(d.loss);
+		r.draws  += popcount64(d.draw);
+
+		//lanes that finished start over until every game has been handed out
+		for(uint32_t done = d.win | d.loss | d.draw; done; done &= done - 1) {
+			size_t i = ctz64(done);
+			if(started < games) {
+				start(i);
+			} else {
+				active &= ~(1u << i);
+			}
+		}
+	}
+
+	return r;
+}
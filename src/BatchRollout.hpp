@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Board.hpp"
+#include "BitBoard.hpp"
+#include "Random.hpp"
+
+#include <cstddef>
+
+//! Instruction sets batchRollouts can run on
+enum class Simd { SCALAR, AVX2, AVX512 };
+
+//! Best instruction set the CPU running this supports
+Simd bestSimd();
+
+//! Wins, draws and losses from one player's point of view
+struct RolloutCounts {
+	size_t wins;
+	size_t draws;
+	size_t losses;
+};
+
+//! Plays games random games from b with toMove to move and counts the
+//! results from the point of view of p. 16 games run in lockstep, one per
+//! vector lane: every step each lane picks a random column, retries next
+//! step if it's full, and checks for four with shifts of the whole lane.
+//! Every Simd level plays exactly the same games for the same g, levels
+//! the CPU doesn't support fall back to the best one it does.
+//! b must not be over.
+RolloutCounts batchRollouts(const BitBoard& b, Board::Player p, Board::Player toMove, size_t games, XorShift& g, Simd simd = bestSimd());
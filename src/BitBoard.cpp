@@ -0,0 +1,132 @@
+#include "BitBoard.hpp"
+#include "Board.hpp"
+#include "Bits.hpp"
+
+#include <cassert>
+#include <sstream>
+#include <string>
+
+bool BitBoard::fits(size_t width, size_t height) {
+	return width != 0 && height != 0 && height < 64 && width * (height + 1) <= 64;
+}
+
+BitBoard::BitBoard(size_t width, size_t height, size_t winLength)
+	: _position(0), _mask(0), _bottomRow(0), _playable(0),
+	  _width(width), _height(height), _winLength(winLength)
+{
+	assert(fits(width, height));
+	assert(winLength >= 2 && winLength <= 32);
+
+	for(size_t x = 0; x < width; x++) {
+		_bottomRow |= bottom(x);
+		_playable  |= column(x);
+	}
+}
+
+BitBoard::BitBoard(const Board& b)
+	: BitBoard(b.width(), b.height(), b.winLength())
+{
+	for(size_t x = 0; x < _width; x++) {
+		for(size_t y = 0; y < _height; y++) {
+			Board::Player p = b(x, y);
+			if(p == Board::Player::E) {
+				break;
+			}
+			put(p, x);
+		}
+	}
+}
+
+void BitBoard::reset() {
+	_position = 0;
+	_mask = 0;
+}
+
+uint64_t BitBoard::mirror(uint64_t bits) const {
+	const size_t stride = _height + 1;
+	const uint64_t col = (uint64_t(1) << stride) - 1;
+
+	uint64_t m = 0;
+	for(size_t x = 0; x < _width; x++) {
+		m |= ((bits >> (x * stride)) & col) << ((_width - 1 - x) * stride);
+	}
+
+	return m;
+}
+
+Board::Player BitBoard::winner() const {
+	auto won = [this](uint64_t pieces) {
+		return _winLength == 4 ? hasFour(pieces, _height) : hasRun(pieces, _height, _winLength);
+	};
+
+	if(won(_position)) {
+		return Board::Player::P1;
+	}
+	if(won(_position ^ _mask)) {
+		return Board::Player::P2;
+	}
+
+	return Board::Player::E;
+}
+
+bool BitBoard::isGameOver() const {
+	return isFull() || winner() != Board::Player::E;
+}
+
+std::string BitBoard::toString() const {
+	std::stringstream s;
+
+	for(size_t row = _height - 1; row < _height; row--) {
+		for(size_t col = 0; col < _width; col++) {
+			auto cell = (*this)(col, row);
+
+			s << (cell == Board::Player::E  ? ". " :
+			      cell == Board::Player::P1 ? "O " :
+			                                  "X ");
+		}
+		s << '\n';
+	}
+
+	for(size_t i = 0; i < 2 * width() - 1; i++) {
+		s << '=';
+	}
+	s << '\n';
+
+	return s.str();
+}
+
+bool causedWin(const BitBoard& b, size_t x, size_t y) {
+	assert(x < b.width());
+	assert(y < b.height());
+
+	Board::Player p = b(x, y);
+	if(p == Board::Player::E) {
+		return false;
+	}
+
+	const unsigned k = b.winLength();
+	const uint64_t own = b.pieces(p);
+	const uint64_t cell = uint64_t(1) << (x * (b.height() + 1) + y);
+	const unsigned dirs[4] = { 1, unsigned(b.height()), unsigned(b.height()) + 1, unsigned(b.height()) + 2 };
+
+	//a run through cell starts at most k - 1 steps below it. Both the
+	//runs and the cells they may start on are folded in log2(k) steps,
+	//the sentinel row and the unused high bits are never set so nothing
+	//wraps around.
+	for(unsigned d : dirs) {
+		uint64_t starts = cell;
+		unsigned len = 1;
+		for(; 2 * len <= k; len *= 2) {
+			starts |= len * d < 64 ? starts >> (len * d) : 0;
+		}
+		if(len < k) {
+			starts |= (k - len) * d < 64 ? starts >> ((k - len) * d) : 0;
+		}
+
+		if(runStarts(own, d, k) & starts) {
+			return true;
+		}
+	}
+
+	return false;
+}
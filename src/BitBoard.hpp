@@ -0,0 +1,232 @@
+#pragma once
+
+#include "Board.hpp"
+#include "Bits.hpp"
+
+#include <cassert>
+#include <cstdint>
+
+//! Board representation for sizes where width * (height + 1) <= 64.
+//! Column x occupies bits [x * (height + 1), (x + 1) * (height + 1)), the
+//! topmost bit of each column is a sentinel that is never set so that
+//! shifted lines can't wrap around into the next column.
+//! _mask holds every piece on the board, _position only P1's pieces.
+//! winLength pieces in a row win, as on Board. The search helpers that
+//! look for threats (threats, Solver, Evaluator, batchRollouts) only
+//! handle four.
+class BitBoard {
+public:
+	//! True if a width x height board can be represented
+	static bool fits(size_t width, size_t height);
+
+	BitBoard(size_t width, size_t height, size_t winLength = 4);
+	explicit BitBoard(const Board& b);
+
+	Board::Player operator()(size_t x, size_t y) const;
+
+	void reset();
+
+	//! Same contract as Board::put
+	size_t put(Board::Player p, size_t x);
+	void unput(size_t x);
+
+	//! Puts a piece for p on cell, which must be a single bit of
+	//! legalMask()
+	void putCell(Board::Player p, uint64_t cell);
+
+	Board::Player winner() const;
+	bool isColumnFull(size_t x) const;
+	bool isFull() const;
+	bool isGameOver() const;
+
+	//! One bit per playable column, set on the cell a piece would land on
+	uint64_t legalMask() const;
+	std::string toString() const;
+
+	//! Pieces belonging to p
+	uint64_t pieces(Board::Player p) const;
+	uint64_t position() const;
+	uint64_t mask() const;
+
+	size_t width() const;
+	size_t height() const;
+	size_t winLength() const;
+
+	//! Returns bits with the columns in reverse order
+	uint64_t mirror(uint64_t bits) const;
+
+	//! Empty cells, playable right away or not, that would complete four
+	//! in a row for p, whatever the win length
+	uint64_t threats(Board::Player p) const;
+
+	//! Every cell on the board
+	uint64_t playable() const;
+
+	//! True if pieces contain four in a row on a board of the given height
+	static bool hasFour(uint64_t pieces, size_t height);
+
+	//! Same for k in a row, see runStarts
+	static bool hasRun(uint64_t pieces, size_t height, size_t k);
+
+private:
+	uint64_t bottom(size_t x) const;
+	uint64_t column(size_t x) const;
+
+	uint64_t _position;
+	uint64_t _mask;
+	uint64_t _bottomRow;
+	uint64_t _playable;
+	unsigned char _width;
+	unsigned char _height;
+	unsigned char _winLength;
+};
+
+//! Same as causedWin(const Board&, ...), only looks at lines through (x, y)
+bool causedWin(const BitBoard& b, size_t x, size_t y);
+
+
+
+inline uint64_t BitBoard::bottom(size_t x) const {
+	return uint64_t(1) << (x * (_height + 1));
+}
+
+inline uint64_t BitBoard::column(size_t x) const {
+	return ((uint64_t(1) << _height) - 1) << (x * (_height + 1));
+}
+
+inline size_t BitBoard::width() const {
+	return _width;
+}
+
+inline size_t BitBoard::height() const {
+	return _height;
+}
+
+inline size_t BitBoard::winLength() const {
+	return _winLength;
+}
+
+inline uint64_t BitBoard::position() const {
+	return _position;
+}
+
+inline uint64_t BitBoard::mask() const {
+	return _mask;
+}
+
+inline uint64_t BitBoard::pieces(Board::Player p) const {
+	return p == Board::Player::P1 ? _position :
+	       p == Board::Player::P2 ? _position ^ _mask :
+	                                0;
+}
+
+inline Board::Player BitBoard::operator()(size_t x, size_t y) const {
+	assert(x < _width);
+	assert(y < _height);
+
+	uint64_t bit = bottom(x) << y;
+	return !(_mask & bit)    ? Board::Player::E  :
+	       (_position & bit) ? Board::Player::P1 :
+	                           Board::Player::P2;
+}
+
+inline size_t BitBoard::put(Board::Player p, size_t x) {
+	assert(x < _width);
+
+	if(p == Board::Player::E) {
+		return _height;
+	}
+
+	uint64_t bit = (_mask + bottom(x)) & column(x);
+	if(!bit) {
+		return _height;
+	}
+
+	_mask |= bit;
+	if(p == Board::Player::P1) {
+		_position |= bit;
+	}
+
+	return ctz64(bit) - x * (_height + 1);
+}
+
+inline void BitBoard::unput(size_t x) {
+	assert(_mask & bottom(x));
+
+	//the next free cell, or the sentinel if the column is full
+	uint64_t top = ((_mask + bottom(x)) & (column(x) | (bottom(x) << _height))) >> 1;
+	_mask &= ~top;
+	_position &= ~top;
+}
+
+inline void BitBoard::putCell(Board::Player p, uint64_t cell) {
+	assert(cell && !(cell & (cell - 1)) && (cell & legalMask()));
+
+	_mask |= cell;
+	if(p == Board::Player::P1) {
+		_position |= cell;
+	}
+}
+
+inline bool BitBoard::isColumnFull(size_t x) const {
+	assert(x < _width);
+	return (_mask & (bottom(x) << (_height - 1))) != 0;
+}
+
+inline bool BitBoard::isFull() const {
+	return _mask == _playable;
+}
+
+inline uint64_t BitBoard::legalMask() const {
+	return (_mask + _bottomRow) & _playable;
+}
+
+inline uint64_t BitBoard::playable() const {
+	return _playable;
+}
+
+inline uint64_t BitBoard::threats(Board::Player p) const {
+	const uint64_t b = pieces(p);
+	const unsigned s = _height + 1;
+
+	//vertical
+	uint64_t r = (b << 1) & (b << 2) & (b << 3);
+
+	//horizontal and both diagonals, the gap can be anywhere in the line
+	const unsigned dirs[3] = { s, s - 1, s + 1 };
+	for(unsigned d : dirs) {
+		uint64_t t = (b << d) & (b << 2 * d);
+		r |= t & (b << 3 * d);
+		r |= t & (b >> d);
+		t = (b >> d) & (b >> 2 * d);
+		r |= t & (b << d);
+		r |= t & (b >> 3 * d);
+	}
+
+	return r & (_playable ^ _mask);
+}
+
+inline bool BitBoard::hasFour(uint64_t b, size_t height) {
+	const unsigned dirs[4] = { 1, unsigned(height), unsigned(height) + 1, unsigned(height) + 2 };
+
+	for(unsigned d : dirs) {
+		uint64_t m = b & (b >> d);
+		if(m & (m >> (2 * d))) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+inline bool BitBoard::hasRun(uint64_t b, size_t height, size_t k) {
+	const unsigned dirs[4] = { 1, unsigned(height), unsigned(height) + 1, unsigned(height) + 2 };
+
+	for(unsigned d : dirs) {
+		if(runStarts(b, d, k)) {
+			return true;
+		}
+	}
+
+	return false;
+}
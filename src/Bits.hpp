@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+
+//! Number of set bits in x
+inline unsigned popcount64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_popcountll(x);
+#else
+	unsigned n = 0;
+	for(; x; x &= x - 1) {
+		n++;
+	}
+	return n;
+#endif
+}
+
+//! Index of the lowest set bit in x, x must not be 0
+inline unsigned ctz64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctzll(x);
+#else
+	unsigned n = 0;
+	for(; !(x & 1); x >>= 1) {
+		n++;
+	}
+	return n;
+#endif
+}
+
+//! Lowest set bit of x left after clearing its n lowest, x must have
+//! more than n bits set
+inline uint64_t nthBit(uint64_t x, unsigned n) {
+	for(; n > 0; n--) {
+		x &= x - 1;
+	}
+	return x & -x;
+}
+
+//! Bits i of x such that i, i + step, ..., i + (k - 1) * step are all
+//! set, the start of every run of k. Runs are folded in, doubling their
+//! length each time, so this takes log2(k) shifts rather than k.
+inline uint64_t runStarts(uint64_t x, unsigned step, unsigned k) {
+	unsigned len = 1;
+	for(; 2 * len <= k; len *= 2) {
+		x = len * step < 64 ? x & (x >> (len * step)) : 0;
+	}
+	//two overlapping runs of len make one of k
+	if(len < k) {
+		x = (k - len) * step < 64 ? x & (x >> ((k - len) * step)) : 0;
+	}
+
+	return x;
+}
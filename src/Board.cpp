@@ -1,5 +1,8 @@
 #include "Board.hpp"
+#include "Bits.hpp"
 
+#include <algorithm>
+#include <cstddef>
 #include <cstring>
 #include <cassert>
 #include <memory>
@@ -8,14 +11,38 @@
 #include <string>
 #include <sstream>
 
-Board::Board(size_t width, size_t height)
+//! splitmix64 finalizer
+static inline uint64_t mix(uint64_t z) {
+	z += 0x9E3779B97F4A7C15ull;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
+
+//! Zobrist key of piece p on (x, y). The keys come from a mixing
+//! function rather than a table so that any board size is covered.
+static inline uint64_t zobrist(size_t x, size_t y, Board::Player p) {
+	return mix(uint64_t(x) << 32 | uint64_t(y) << 2 | uint64_t(p));
+}
+
+//! Key of the empty board, so that the same stones on boards of
+//! different sizes or win lengths hash differently. The low bits are 3,
+//! which no piece key has.
+static inline uint64_t geometryKey(size_t width, size_t height, size_t winLength) {
+	return mix(uint64_t(width) << 40 | uint64_t(height) << 8 | uint64_t(winLength) << 2 | 3);
+}
+
+Board::Board(size_t width, size_t height, size_t winLength)
 	: _lMovs(),
           _cells(std::unique_ptr<Player[]>(new Player[width * height]())),
-	  _rowPtrs(std::unique_ptr<Player*[]>(new Player*[width])),
+	  _rowPtrs(std::unique_ptr<Player*[]>(new Player*[height])),
 	  _colHeight(std::unique_ptr<size_t[]>(new size_t[width]())),
-	  _width(width), _height(height)
+	  _width(width), _height(height), _winLength(winLength),
+	  _filled(0), _winner(Player::E), _winX(0), _winY(0), _winFilled(0),
+	  _hash(geometryKey(width, height, winLength)), _mirrorHash(_hash)
 {
 	assert(height != 0 && ((width * height) / height) == width);
+	assert(winLength >= 2 && winLength <= 32);
 
 	for(size_t row = 0; row < height; row++) {
 		_rowPtrs[row] = &_cells[row * width];
@@ -29,9 +56,11 @@ Board::Board(size_t width, size_t height)
 Board::Board(const Board& o)
 	: _lMovs(o._lMovs),
           _cells(std::unique_ptr<Player[]>(new Player[o._width * o._height])),
-	  _rowPtrs(std::unique_ptr<Player*[]>(new Player*[o._width])),
+	  _rowPtrs(std::unique_ptr<Player*[]>(new Player*[o._height])),
 	  _colHeight(std::unique_ptr<size_t[]>(new size_t[o._width])),
-	  _width(o._width), _height(o._height)
+	  _width(o._width), _height(o._height), _winLength(o._winLength),
+	  _filled(o._filled), _winner(o._winner), _winX(o._winX), _winY(o._winY),
+	  _winFilled(o._winFilled), _hash(o._hash), _mirrorHash(o._mirrorHash)
 {
 	for(size_t i = 0; i < _width * _height; i++) {
 		_cells[i] = o._cells[i];
@@ -48,14 +77,16 @@ Board::Board(const Board& o)
 
 Board::Board(Board&& o)
 	: _lMovs(std::move(o._lMovs)), _cells(std::move(o._cells)), _rowPtrs(std::move(o._rowPtrs)),
-          _colHeight(std::move(o._colHeight)), _width(o._width), _height(o._height)
+          _colHeight(std::move(o._colHeight)), _width(o._width), _height(o._height),
+	  _winLength(o._winLength), _filled(o._filled), _winner(o._winner), _winX(o._winX), _winY(o._winY),
+	  _winFilled(o._winFilled), _hash(o._hash), _mirrorHash(o._mirrorHash)
 {
 	o._width = 0;
 	o._height = 0;
 }
 
 Board& Board::operator=(const Board& o) {
-	if(!(_width <= o._width && _height <= o._height)) {
+	if(_width != o._width || _height != o._height) {
 		_cells.reset(new Player[o._width * o._height]);
 		_rowPtrs.reset(new Player*[o._height]);
 		_colHeight.reset(new size_t[o._width]);
@@ -63,7 +94,15 @@ Board& Board::operator=(const Board& o) {
 
 	_width = o._width;
 	_height = o._height;
+	_winLength = o._winLength;
 	_lMovs = o._lMovs;
+	_filled = o._filled;
+	_winner = o._winner;
+	_winX = o._winX;
+	_winY = o._winY;
+	_winFilled = o._winFilled;
+	_hash = o._hash;
+	_mirrorHash = o._mirrorHash;
 
 	for(size_t i = 0; i < o._width * o._height; i++) {
 		_cells[i] = o._cells[i];
@@ -82,11 +121,20 @@ Board& Board::operator=(const Board& o) {
 
 Board& Board::operator=(Board&& o) {
 	_cells = std::move(o._cells);
+	_rowPtrs = std::move(o._rowPtrs);
 	_colHeight = std::move(o._colHeight);
 	_lMovs = std::move(o._lMovs);
 
 	_width = o._width;
 	_height = o._height;
+	_winLength = o._winLength;
+	_filled = o._filled;
+	_winner = o._winner;
+	_winX = o._winX;
+	_winY = o._winY;
+	_winFilled = o._winFilled;
+	_hash = o._hash;
+	_mirrorHash = o._mirrorHash;
 
 	o._width  = 0;
 	o._height = 0;
@@ -94,26 +142,13 @@ Board& Board::operator=(Board&& o) {
 	return *this;
 }
 
-size_t Board::width() const {
-	return _width;
-}
 
-size_t Board::height() const {
-	return _height;
+uint64_t Board::hash() const {
+	return _hash;
 }
 
-Board::Player& Board::get(size_t x, size_t y) {
-	assert(x < _width);
-	assert(y < _height);
-
-	return _rowPtrs[y][x];
-}
-
-Board::Player Board::operator()(size_t x, size_t y) const {
-	assert(x < _width);
-	assert(y < _height);
-
-	return _rowPtrs[y][x];
+uint64_t Board::canonicalHash() const {
+	return std::min(_hash, _mirrorHash);
 }
 
 void Board::reset() {
@@ -121,6 +156,18 @@ void Board::reset() {
 	for(size_t i = 0; i < total; i++) {
 		_cells[i] = Player::E;
 	}
+
+	_lMovs.clear();
+	for(size_t i = 0; i < _width; i++) {
+		_colHeight[i] = 0;
+		_lMovs.push_back(i);
+	}
+
+	_filled = 0;
+	_winner = Player::E;
+	_winFilled = 0;
+	_hash = geometryKey(_width, _height, _winLength);
+	_mirrorHash = _hash;
 }
 
 size_t Board::put(Board::Player p, size_t x) {
@@ -131,7 +178,12 @@ size_t Board::put(Board::Player p, size_t x) {
 	}
 
 	if(_colHeight[x] < _height) {
-		get(x, _colHeight[x]++) = p;
+		size_t y = _colHeight[x]++;
+		get(x, y) = p;
+		_filled++;
+		_hash ^= zobrist(x, y, p);
+		_mirrorHash ^= zobrist(_width - 1 - x, y, p);
+
 		if(_colHeight[x] >= _height) {
 			for(auto it = _lMovs.begin(); it != _lMovs.end(); ++it) {
 				if(*it == x) {
@@ -141,7 +193,14 @@ size_t Board::put(Board::Player p, size_t x) {
 			}
 		}
 
-		return _colHeight[x] - 1;
+		if(_winner == Player::E && causedWin(*this, x, y)) {
+			_winner = p;
+			_winX = x;
+			_winY = y;
+			_winFilled = _filled;
+		}
+
+		return y;
 	}
 	
 	return _height;
@@ -153,115 +212,30 @@ void Board::unput(size_t x) {
 	if(_colHeight[x] >= _height) {
 		_lMovs.push_back(x);
 	}
-	get(x, --_colHeight[x]) = Player::E;
-}
-
-bool Board::isColumnFull(size_t x) const {
-	assert(x < _width);
-	return _colHeight[x] >= _height;
-}
-
-bool Board::isFull() const {
-	for(size_t i = 0; i < _width; i++) {
-		if(_colHeight[i] < _height) {
-			return false;
+	size_t y = --_colHeight[x];
+	_hash ^= zobrist(x, y, get(x, y));
+	_mirrorHash ^= zobrist(_width - 1 - x, y, get(x, y));
+	get(x, y) = Player::E;
+	_filled--;
+
+	if(_winner != Player::E) {
+		//taking back the winning move right after it was played is
+		//the common case in search, and there was no winner before it
+		if(x == _winX && y == _winY && _filled + 1 == _winFilled) {
+			_winner = Player::E;
+		} else {
+			_winner = scanWinner();
+			_winFilled = 0;
 		}
 	}
-
-	return true;
-}
-
-static inline bool checkHorizontal(const Board& b, size_t x, size_t y) {
-	auto one   = b(x-0, y);
-	auto two   = b(x-1, y);
-	auto three = b(x-2, y);
-	auto four  = b(x-3, y);
-
-	return (one == two) & (two == three) & (three == four);
-}
-
-static inline bool checkVertical(const Board& b, size_t x, size_t y) {
-	auto one   = b(x, y-0);
-	auto two   = b(x, y-1);
-	auto three = b(x, y-2);
-	auto four  = b(x, y-3);
-
-	return (one == two) & (two == three) & (three == four);
-}
-
-static inline bool checkUDiag(const Board& b, size_t x, size_t y) {
-	auto one   = b(x-0, y-0);
-	auto two   = b(x-1, y-1);
-	auto three = b(x-2, y-2);
-	auto four  = b(x-3, y-3);
-
-	return (one == two) & (two == three) & (three == four);
 }
 
-static inline bool checkLDiag(const Board& b, size_t x, size_t y) {
-	auto one   = b(x-0, y+0);
-	auto two   = b(x-1, y+1);
-	auto three = b(x-2, y+2);
-	auto four  = b(x-3, y+3);
-
-	return (one == two) & (two == three) & (three == four);
-}
-
-Board::Player Board::winner() const {
-	//---+-------+
-	//   |   2   |
-	// 1 +-------+
-	//   |   3   |
-	//---+-------+
-	// 0 |   4   |
-	//---+-------+
-	
-	//ONE
-	for(size_t x = 0; x < 3; x++) {
-		for(size_t y = 3; y < _colHeight[x]; y++) {
-			Player p = (*this)(x, y);
-
-			if(checkVertical(*this, x, y)) {
-				return p;
-			}
-		}
-	}
-
-	//TWO
-	for(size_t x = 3; x < _width; x++) {
-		for(size_t y = _height - 3; y < _colHeight[x]; y++) {
-			Player p = (*this)(x, y);
-
-			if(checkHorizontal(*this, x, y) ||
-			   checkVertical(*this,  x, y)  ||
-			   checkUDiag(*this, x, y)) {
-				return p;
-			}
-		}
-	}
-
-	//THREE
-	for(size_t x = 3; x < _width; x++) {
-		for(size_t y = 3; y < _colHeight[x] && y < _height - 3; y++) {
-			Player p = (*this)(x, y);
-
-			if(checkHorizontal(*this, x, y) ||
-			   checkVertical(*this,  x, y)  ||
-			   checkUDiag(*this, x, y) ||
-			   checkLDiag(*this, x, y)) {
-				return p;
-			}
-		}
-	}
-
-	//FOUR
-	for(size_t x = 3; x < _width; x++) {
-		for(size_t y = 0; y < _colHeight[x] && y < 3; y++) {
-			Player p = (*this)(x, y);
-
-			if(checkHorizontal(*this, x, y) ||
-			   checkLDiag(*this, x, y)) {
-				return p;
+Board::Player Board::scanWinner() const {
+	//a winning line runs through cells of its owner
+	for(size_t x = 0; x < _width; x++) {
+		for(size_t y = 0; y < _colHeight[x]; y++) {
+			if(causedWin(*this, x, y)) {
+				return (*this)(x, y);
 			}
 		}
 	}
@@ -270,11 +244,7 @@ Board::Player Board::winner() const {
 }
 
 bool Board::isGameOver() const {
-	return isFull() || winner() != Player::E;
-}
-
-const std::vector<size_t>& Board::legalMoves() const {
-	return _lMovs;
+	return _winner != Player::E || isFull();
 }
 
 std::string Board::toString() const {
@@ -299,61 +269,54 @@ std::string Board::toString() const {
 	return s.str();
 }
 
-bool causedWin(const Board& b, size_t xx, size_t yy) {
-	assert(xx < b.width());
-	assert(yy < b.height());
+//! causedWin on the cells of a board, p is the piece on (x, y). K is the
+//! win length when it's one of the usual ones, so the loops unroll, or
+//! 0 to use winLength.
+template<int K>
+static bool foldedWin(const Board::Player* cells, size_t width, size_t height, size_t x, size_t y,
+                      Board::Player p, int winLength) {
+	const int k = K ? K : winLength;
+	const size_t at = y * width + x;
+
+	//the cells of the line through (x, y) along (dx, dy) that could be
+	//part of a run with it go into one word. The loop has the same
+	//length wherever (x, y) is, cells off the board read (x, y) instead
+	//and get masked out, so nothing branches on the position or the
+	//contents. The runs are then folded in log2(k) steps, rather than
+	//comparing every window of k cells.
+	auto line = [&](int dx, int dy, int lo) {
+		const ptrdiff_t step = dx + dy * ptrdiff_t(width);
+		uint64_t bits = 0;
+		for(int i = lo; i < k; i++) {
+			//negative coordinates wrap around and fail the bounds check
+			bool in = (x + size_t(i * dx) < width) & (y + size_t(i * dy) < height);
+			bits |= uint64_t(in & (cells[in ? at + i * step : at] == p)) << (i - lo);
+		}
+		return runStarts(bits, 1, k) != 0;
+	};
+
+	//the cells above a piece are empty when it goes in, and a scan
+	//finds vertical lines from their top piece
+	return line(0, -1, 0) ||
+	       line(1, 0, 1 - k) ||
+	       line(1, 1, 1 - k) ||
+	       line(1, -1, 1 - k);
+}
+
+bool causedWin(const Board& b, size_t x, size_t y) {
+	assert(x < b.width());
+	assert(y < b.height());
 
-	Board::Player p = b(xx, yy);
+	const Board::Player* cells = b._cells.get();
+	Board::Player p = cells[y * b._width + x];
 	if(p == Board::Player::E) {
 		return false;
 	}
-	
-	int x = xx;
-	int y = yy;
-	int width  = b.width();
-	int height = b.height();
-	
-	bool success = false;
-	//horizontal
-	for(int i = std::max(0, x - 3); i < std::min(width - 3, x + 1); i++) {
-		success |= (b(i+0, y) == p) &
-		           (b(i+1, y) == p) &
-		           (b(i+2, y) == p) &
-		           (b(i+3, y) == p);
-	}
-	
-	//vertical
-	if(y >= 3) {
-		success |= (b(x, y-0) == p) &
-			   (b(x, y-1) == p) &
-			   (b(x, y-2) == p) &
-			   (b(x, y-3) == p);
-	}
-	
-	if(success) {
-		return true;
-	}
-
-	//upper diagonal
-	for(int i = std::max(-3, -std::min(x, y)); i < std::min(1, std::min(width-x, height-y) -3); i++) {
-		success |= (b(x+i+0, y+i+0) == p) &
-		           (b(x+i+1, y+i+1) == p) &
-		           (b(x+i+2, y+i+2) == p) &
-		           (b(x+i+3, y+i+3) == p);
-	}
 
-	if(success) { 
-		return true;
+	switch(b._winLength) {
+	case 4:  return foldedWin<4>(cells, b._width, b._height, x, y, p, 4);
+	case 5:  return foldedWin<5>(cells, b._width, b._height, x, y, p, 5);
+	case 6:  return foldedWin<6>(cells, b._width, b._height, x, y, p, 6);
+	default: return foldedWin<0>(cells, b._width, b._height, x, y, p, b._winLength);
 	}
-	
-	//lower diagonal
-	for(int i = std::max(-3, -std::min(x, height-y-1)); i < std::min(1, std::min(width-x, y+1) -3); i++) {
-		success |= (b(x+i+0, y-i-0) == p) &
-		           (b(x+i+1, y-i-1) == p) &
-		           (b(x+i+2, y-i-2) == p) &
-		           (b(x+i+3, y-i-3) == p);
-	}
-	
-	return success;
 }
-
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cassert>
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include <string>
@@ -8,7 +10,8 @@ class Board {
 public:
 	enum class Player : unsigned char { E = 0, P1 = 1, P2 = 2, NONE = 3 };
 	
-	Board(size_t width, size_t height);
+	//! winLength pieces in a row win, 2 to 32
+	Board(size_t width, size_t height, size_t winLength = 4);
 	Board(const Board& o);
 	Board(Board&& o);
 	Board& operator=(const Board& o);
@@ -33,9 +36,19 @@ public:
 
 	size_t width() const;
 	size_t height() const;
+	size_t winLength() const;
+
+	//! Zobrist hash of the position, updated incrementally by put/unput.
+	//! Width, height and win length are part of it.
+	uint64_t hash() const;
+	//! Same for a position and its mirror image, also O(1)
+	uint64_t canonicalHash() const;
 
 private:
+	friend bool causedWin(const Board& b, size_t x, size_t y);
+
 	Player& get(size_t x, size_t y);
+	Player scanWinner() const;
 	
 	std::vector<size_t> _lMovs;
 	std::unique_ptr<Player[]> _cells;
@@ -43,9 +56,64 @@ private:
 	std::unique_ptr<size_t[]> _colHeight;
 	size_t _width;
 	size_t _height;
+	size_t _winLength;
+
+	//kept up to date by put/unput so the game state queries are O(1)
+	size_t _filled;
+	Player _winner;
+	size_t _winX;
+	size_t _winY;
+	//value of _filled right after the winning piece went in, 0 if unknown
+	size_t _winFilled;
+	uint64_t _hash;
+	//hash of the mirror image
+	uint64_t _mirrorHash;
 };
 
 //! More efficient than calling winner() if the position of
 //! the last move is known
 bool causedWin(const Board& b, size_t x, size_t y);
 
+
+inline size_t Board::width() const {
+	return _width;
+}
+
+inline size_t Board::height() const {
+	return _height;
+}
+
+inline size_t Board::winLength() const {
+	return _winLength;
+}
+
+inline Board::Player& Board::get(size_t x, size_t y) {
+	assert(x < _width);
+	assert(y < _height);
+
+	return _rowPtrs[y][x];
+}
+
+inline Board::Player Board::operator()(size_t x, size_t y) const {
+	assert(x < _width);
+	assert(y < _height);
+
+	return _rowPtrs[y][x];
+}
+
+inline Board::Player Board::winner() const {
+	return _winner;
+}
+
+inline bool Board::isColumnFull(size_t x) const {
+	assert(x < _width);
+	return _colHeight[x] >= _height;
+}
+
+inline bool Board::isFull() const {
+	return _filled == _width * _height;
+}
+
+inline const std::vector<size_t>& Board::legalMoves() const {
+	return _lMovs;
+}
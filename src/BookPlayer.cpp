@@ -0,0 +1,50 @@
+#include "BookPlayer.hpp"
+#include "BitBoard.hpp"
+#include "Board.hpp"
+#include "OpeningBook.hpp"
+#include "SearchStats.hpp"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+BookPlayer::BookPlayer(const std::string& bookPath, std::unique_ptr<Player> fallback)
+	: _book(bookPath), _fallback(std::move(fallback))
+{
+	if(!_fallback) {
+		throw std::invalid_argument("BookPlayer needs a fallback player");
+	}
+}
+
+size_t BookPlayer::makeMove(const Board& b, Board::Player p) {
+	if(p == Board::Player::E) {
+		throw std::invalid_argument("Passed E as player");
+	}
+
+	_stats.clear();
+
+	if(b.width() == _book.width() && b.height() == _book.height()) {
+		size_t move;
+		int score;
+		if(_book.lookup(BitBoard(b), p, move, score) && move < b.width() && !b.isColumnFull(move)) {
+			_stats.book = true;
+			_stats.move = move;
+			if(score != OpeningBook::UNKNOWN_SCORE) {
+				_stats.score = score > 0 ? 1 : score < 0 ? -1 : 0;
+			}
+			return move;
+		}
+	}
+
+	size_t move = _fallback->makeMove(b, p);
+	if(_fallback->lastStats()) {
+		_stats = *_fallback->lastStats();
+	}
+	_stats.move = move;
+
+	return move;
+}
+
+const SearchStats* BookPlayer::lastStats() const {
+	return &_stats;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Player.hpp"
+#include "OpeningBook.hpp"
+#include "SearchStats.hpp"
+
+#include <memory>
+#include <string>
+
+//! Plays from an opening book while the position is in it, then
+//! defers to another player
+class BookPlayer : public Player {
+public:
+	BookPlayer(const std::string& bookPath, std::unique_ptr<Player> fallback);
+	virtual size_t makeMove(const Board& b, Board::Player p);
+	//! Marks book moves, passes on the fallback's stats for the rest
+	virtual const SearchStats* lastStats() const;
+
+private:
+	OpeningBook _book;
+	std::unique_ptr<Player> _fallback;
+	SearchStats _stats;
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+//! A root move's value and how far off it may be
+struct Estimate {
+	float value;
+	float radius;
+};
+
+//! Half width of a Hoeffding interval around the mean of games rollout
+//! results in [-1, 1]: the true mean lies within it with probability at
+//! least 1 - delta. Infinite without games.
+inline float hoeffdingRadius(size_t games, double delta) {
+	if(games == 0) {
+		return std::numeric_limits<float>::infinity();
+	}
+
+	return float(std::sqrt(2 * std::log(2 / delta) / games));
+}
+
+//! delta for each of moves intervals at the check-th check of a search,
+//! counting from 1. The deltas of every interval at every check add up
+//! to at most delta, so with probability 1 - delta all of them hold
+//! however many checks are made.
+inline double checkDelta(double delta, size_t moves, size_t check) {
+	return delta / (double(moves) * double(check) * double(check + 1));
+}
+
+//! True if the estimate with the highest value is the best one for as
+//! long as all the intervals hold, its own lying wholly above every
+//! other one. Values are in [-1, 1],
+//! so the intervals are clipped to that, or infinite for proven results
+//! with a radius of 0.
+inline bool separated(const std::vector<Estimate>& e) {
+	size_t best = 0;
+	for(size_t i = 1; i < e.size(); i++) {
+		if(e[i].value > e[best].value) {
+			best = i;
+		}
+	}
+
+	const float low = e[best].radius ? std::max(e[best].value - e[best].radius, -1.0f) : e[best].value;
+	for(size_t i = 0; i < e.size(); i++) {
+		const float high = e[i].radius ? std::min(e[i].value + e[i].radius, 1.0f) : e[i].value;
+		if(i != best && !(low > high)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//! Default delta the players stop their rollouts early with
+const double EARLY_STOP_DELTA = 0.001;
@@ -0,0 +1,90 @@
+#include "Evaluator.hpp"
+#include "BitBoard.hpp"
+#include "Bits.hpp"
+#include "Board.hpp"
+
+#include <cstdlib>
+#include <stdexcept>
+
+constexpr float Evaluator::MAX_SCORE;
+
+//weights of the terms, in units of an open two
+static const int THREAT = 6;
+static const int GOOD_THREAT = 10;
+static const int CENTER = 2;
+//raw value at which evaluate reaches half of MAX_SCORE
+static const int HALF = 40;
+
+Evaluator::Evaluator(size_t width, size_t height)
+	: _width(width), _height(height), _oddRows(0), _center(0)
+{
+	if(!BitBoard::fits(width, height)) {
+		throw std::invalid_argument("Board doesn't fit in a BitBoard");
+	}
+
+	const size_t stride = height + 1;
+	for(size_t x = 0; x < width; x++) {
+		for(size_t y = 0; y < height; y += 2) {
+			_oddRows |= uint64_t(1) << (x * stride + y);
+		}
+	}
+
+	//both middle columns on even widths
+	const uint64_t column = (uint64_t(1) << height) - 1;
+	_center |= column << (width / 2 * stride);
+	_center |= column << ((width - 1) / 2 * stride);
+}
+
+size_t Evaluator::width() const {
+	return _width;
+}
+
+size_t Evaluator::height() const {
+	return _height;
+}
+
+Evaluator::Terms Evaluator::terms(const BitBoard& b, Board::Player p) const {
+	const uint64_t own = b.pieces(p);
+	const uint64_t open = own | (b.playable() & ~b.mask());
+	const unsigned s = _height + 1;
+
+	//lines are counted at their lowest bit, cells outside the board
+	//and sentinels are never open so lines can't wrap
+	int twos = 0;
+	const unsigned dirs[4] = { 1, s, s - 1, s + 1 };
+	for(unsigned d : dirs) {
+		uint64_t line = open & (open >> d) & (open >> 2 * d) & (open >> 3 * d);
+
+		//exactly two of the four cells are own pieces
+		uint64_t a0 = own ^ (own >> d);
+		uint64_t b0 = own & (own >> d);
+		uint64_t a1 = (own >> 2 * d) ^ (own >> 3 * d);
+		uint64_t b1 = (own >> 2 * d) & (own >> 3 * d);
+		uint64_t two = (b0 & ~(a1 | b1)) | (b1 & ~(a0 | b0)) | (a0 & a1);
+
+		twos += popcount64(line & two);
+	}
+
+	const uint64_t threats = b.threats(p);
+	const uint64_t good = p == Board::Player::P1 ? _oddRows : ~_oddRows;
+
+	return { twos, int(popcount64(threats)), int(popcount64(threats & good)), int(popcount64(own & _center)) };
+}
+
+static int weigh(const Evaluator::Terms& t) {
+	return t.twos + THREAT * t.threats + GOOD_THREAT * t.goodThreats + CENTER * t.center;
+}
+
+int Evaluator::raw(const BitBoard& b, Board::Player p) const {
+	Board::Player o = p == Board::Player::P1 ? Board::Player::P2 : Board::Player::P1;
+	return weigh(terms(b, p)) - weigh(terms(b, o));
+}
+
+float Evaluator::evaluate(const BitBoard& b, Board::Player p, Board::Player toMove) const {
+	if(b.threats(toMove) & b.legalMask()) {
+		return toMove == p ? MAX_SCORE : -MAX_SCORE;
+	}
+
+	int r = raw(b, p);
+	return MAX_SCORE * float(r) / float(std::abs(r) + HALF);
+}
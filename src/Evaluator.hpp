@@ -0,0 +1,53 @@
+#pragma once
+
+#include "BitBoard.hpp"
+#include "Board.hpp"
+
+#include <cstdint>
+
+//! Static evaluation of positions that fit in a BitBoard, for the
+//! leaves of a depth limited search. Looks at
+//!   threats   empty cells that would complete a four, worth more on
+//!             the rows that suit their owner: odd rows (counting from
+//!             1) for P1, even ones for P2
+//!   twos      lines of four with two of a player's pieces and two
+//!             empty cells
+//!   center    pieces in the middle column(s)
+//! All of it is computed with shifts and popcounts over whole boards.
+class Evaluator {
+public:
+	//! Largest magnitude evaluate returns, short of a proven result
+	static constexpr float MAX_SCORE = 0.99f;
+
+	//! What one player has on the board
+	struct Terms {
+		int twos;
+		int threats;
+		//threats on rows that suit the player
+		int goodThreats;
+		int center;
+	};
+
+	Evaluator(size_t width, size_t height);
+
+	size_t width() const;
+	size_t height() const;
+
+	//! Value of b for p with toMove to play, in
+	//! [-MAX_SCORE, MAX_SCORE]. A threat toMove can play right away
+	//! counts as a win. b must be this evaluator's size.
+	float evaluate(const BitBoard& b, Board::Player p, Board::Player toMove) const;
+
+	//! Unscaled value of b for p, positive when p is better off.
+	//! Ignores immediate wins.
+	int raw(const BitBoard& b, Board::Player p) const;
+
+	Terms terms(const BitBoard& b, Board::Player p) const;
+
+private:
+	size_t _width;
+	size_t _height;
+	//cells on odd rows, counting from 1
+	uint64_t _oddRows;
+	uint64_t _center;
+};
@@ -0,0 +1,276 @@
+#pragma once
+
+#include "Board.hpp"
+#include "MoveList.hpp"
+
+#include <cassert>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+//! Board with dimensions fixed at compile time. All the storage is
+//! inline, so copying or assigning one is a single memcpy and never
+//! touches the allocator. Mirrors the interface of Board, with four in
+//! a row to win.
+//!
+//! Players don't dispatch runtime sizes to it: sizes that fit go to a
+//! BitBoard, the rest to a BasicWideBitBoard, which is faster than a
+//! FixedBoard even on 9x7 (see BM_BoardRollouts9x7).
+template<size_t W, size_t H>
+class FixedBoard {
+public:
+	typedef BasicMoveList<W> Moves;
+
+	FixedBoard();
+	explicit FixedBoard(const Board& b);
+
+	Board::Player operator()(size_t x, size_t y) const;
+
+	void reset();
+
+	//! Same contract as Board::put
+	size_t put(Board::Player p, size_t x);
+	void unput(size_t x);
+
+	Board::Player winner() const;
+	bool isColumnFull(size_t x) const;
+	bool isFull() const;
+	bool isGameOver() const;
+
+	const Moves& legalMoves() const;
+	std::string toString() const;
+
+	static constexpr size_t width()  { return W; }
+	static constexpr size_t height() { return H; }
+
+private:
+	Board::Player& get(size_t x, size_t y);
+	Board::Player scanWinner() const;
+
+	//column major, so a column is contiguous
+	Board::Player _cells[W * H];
+	unsigned char _colHeight[W];
+	Moves _lMovs;
+
+	//same incremental bookkeeping as Board
+	unsigned short _filled;
+	unsigned short _winFilled;
+	Board::Player _winner;
+	unsigned char _winX;
+	unsigned char _winY;
+};
+
+template<size_t W, size_t H>
+bool causedWin(const FixedBoard<W, H>& b, size_t x, size_t y);
+
+
+template<size_t W, size_t H>
+FixedBoard<W, H>::FixedBoard() {
+	static_assert(W > 0 && H > 0 && H < 256 && W * H < 65536, "Invalid board dimensions");
+	static_assert(std::is_trivially_copyable<FixedBoard>::value, "FixedBoard must stay trivially copyable");
+
+	reset();
+}
+
+template<size_t W, size_t H>
+FixedBoard<W, H>::FixedBoard(const Board& b)
+	: FixedBoard()
+{
+	assert(b.width() == W && b.height() == H && b.winLength() == 4);
+
+	for(size_t x = 0; x < W; x++) {
+		for(size_t y = 0; y < H && b(x, y) != Board::Player::E; y++) {
+			put(b(x, y), x);
+		}
+	}
+}
+
+template<size_t W, size_t H>
+inline Board::Player& FixedBoard<W, H>::get(size_t x, size_t y) {
+	assert(x < W);
+	assert(y < H);
+
+	return _cells[x * H + y];
+}
+
+template<size_t W, size_t H>
+inline Board::Player FixedBoard<W, H>::operator()(size_t x, size_t y) const {
+	assert(x < W);
+	assert(y < H);
+
+	return _cells[x * H + y];
+}
+
+template<size_t W, size_t H>
+void FixedBoard<W, H>::reset() {
+	std::memset(_cells, 0, sizeof(_cells));
+	std::memset(_colHeight, 0, sizeof(_colHeight));
+
+	_lMovs.clear();
+	for(size_t i = 0; i < W; i++) {
+		_lMovs.push_back(i);
+	}
+
+	_filled = 0;
+	_winFilled = 0;
+	_winner = Board::Player::E;
+	_winX = 0;
+	_winY = 0;
+}
+
+template<size_t W, size_t H>
+inline size_t FixedBoard<W, H>::put(Board::Player p, size_t x) {
+	assert(x < W);
+
+	if(p == Board::Player::E || _colHeight[x] >= H) {
+		return H;
+	}
+
+	size_t y = _colHeight[x]++;
+	get(x, y) = p;
+	_filled++;
+
+	if(_colHeight[x] >= H) {
+		_lMovs.erase(x);
+	}
+
+	if(_winner == Board::Player::E && causedWin(*this, x, y)) {
+		_winner = p;
+		_winX = x;
+		_winY = y;
+		_winFilled = _filled;
+	}
+
+	return y;
+}
+
+template<size_t W, size_t H>
+inline void FixedBoard<W, H>::unput(size_t x) {
+	assert(x < W);
+	assert(_colHeight[x] != 0);
+
+	if(_colHeight[x] >= H) {
+		_lMovs.push_back(x);
+	}
+	size_t y = --_colHeight[x];
+	get(x, y) = Board::Player::E;
+	_filled--;
+
+	if(_winner != Board::Player::E) {
+		if(x == _winX && y == _winY && _filled + 1 == _winFilled) {
+			_winner = Board::Player::E;
+		} else {
+			_winner = scanWinner();
+			_winFilled = 0;
+		}
+	}
+}
+
+template<size_t W, size_t H>
+inline bool FixedBoard<W, H>::isColumnFull(size_t x) const {
+	assert(x < W);
+	return _colHeight[x] >= H;
+}
+
+template<size_t W, size_t H>
+inline bool FixedBoard<W, H>::isFull() const {
+	return _filled == W * H;
+}
+
+template<size_t W, size_t H>
+inline Board::Player FixedBoard<W, H>::winner() const {
+	return _winner;
+}
+
+template<size_t W, size_t H>
+Board::Player FixedBoard<W, H>::scanWinner() const {
+	//every line is checked once, from its lowest leftmost cell
+	for(size_t x = 0; x < W; x++) {
+		for(size_t y = 0; y < _colHeight[x]; y++) {
+			Board::Player p = (*this)(x, y);
+
+			if(y + 3 < H && (*this)(x, y+1) == p && (*this)(x, y+2) == p && (*this)(x, y+3) == p) {
+				return p;
+			}
+
+			if(x + 3 >= W) {
+				continue;
+			}
+
+			if((*this)(x+1, y) == p && (*this)(x+2, y) == p && (*this)(x+3, y) == p) {
+				return p;
+			}
+			if(y + 3 < H && (*this)(x+1, y+1) == p && (*this)(x+2, y+2) == p && (*this)(x+3, y+3) == p) {
+				return p;
+			}
+			if(y >= 3 && (*this)(x+1, y-1) == p && (*this)(x+2, y-2) == p && (*this)(x+3, y-3) == p) {
+				return p;
+			}
+		}
+	}
+
+	return Board::Player::E;
+}
+
+template<size_t W, size_t H>
+inline bool FixedBoard<W, H>::isGameOver() const {
+	return _winner != Board::Player::E || isFull();
+}
+
+template<size_t W, size_t H>
+inline const typename FixedBoard<W, H>::Moves& FixedBoard<W, H>::legalMoves() const {
+	return _lMovs;
+}
+
+template<size_t W, size_t H>
+std::string FixedBoard<W, H>::toString() const {
+	std::stringstream s;
+
+	for(size_t row = H - 1; row < H; row--) {
+		for(size_t col = 0; col < W; col++) {
+			auto cell = (*this)(col, row);
+
+			s << (cell == Board::Player::E  ? ". " :
+			      cell == Board::Player::P1 ? "O " :
+			                                  "X ");
+		}
+		s << '\n';
+	}
+
+	for(size_t i = 0; i < 2 * W - 1; i++) {
+		s << '=';
+	}
+	s << '\n';
+
+	return s.str();
+}
+
+template<size_t W, size_t H>
+bool causedWin(const FixedBoard<W, H>& b, size_t x, size_t y) {
+	assert(x < W);
+	assert(y < H);
+
+	Board::Player p = b(x, y);
+	if(p == Board::Player::E) {
+		return false;
+	}
+
+	//counts matching pieces walking away from (x, y) in direction (dx, dy)
+	auto run = [&](int dx, int dy) {
+		int n = 0;
+		int cx = int(x) + dx;
+		int cy = int(y) + dy;
+		while(n < 3 && cx >= 0 && cx < int(W) && cy >= 0 && cy < int(H) && b(cx, cy) == p) {
+			n++;
+			cx += dx;
+			cy += dy;
+		}
+		return n;
+	};
+
+	return run(0, -1) >= 3 ||
+	       run(-1, 0) + run(1,  0) >= 3 ||
+	       run(-1,-1) + run(1,  1) >= 3 ||
+	       run(-1, 1) + run(1, -1) >= 3;
+}
@@ -4,11 +4,11 @@
 #include <cassert>
 
 Game::Game(Board&& b, std::unique_ptr<Player> p1, std::unique_ptr<Player> p2)
-	: _board(b), _p1(std::move(p1)), _p2(std::move(p2)), _toMove(Board::Player::P1)
+	: _board(b), _p1(std::move(p1)), _p2(std::move(p2)), _toMove(Board::Player::P1), _record(nullptr)
 {}
 
 Game::Game(const Board& b, std::unique_ptr<Player> p1, std::unique_ptr<Player> p2)
-	: _board(b), _p1(std::move(p1)), _p2(std::move(p2)), _toMove(Board::Player::P1)
+	: _board(b), _p1(std::move(p1)), _p2(std::move(p2)), _toMove(Board::Player::P1), _record(nullptr)
 {}
 
 Board& Game::board() {
@@ -37,15 +37,39 @@ Board::Player Game::step() {
 		throw std::domain_error("Player returned invalid move.");
 	}
 
-	size_t y = _board.put(_toMove, move);
+	_board.put(_toMove, move);
+	if(_record) {
+		_record->move(move);
+	}
 
-	
-	Board::Player toRet = causedWin(_board, move, y) ? _toMove :
-	                      _board.isFull()            ? Board::Player::E :
-	                                                   Board::Player::NONE;
+	Board::Player toRet = _board.winner() != Board::Player::E ? _toMove :
+	                      _board.isFull()                     ? Board::Player::E :
+	                                                            Board::Player::NONE;
 	
 	_toMove = _toMove == Board::Player::P2 ? Board::Player::P1 :
 	                                         Board::Player::P2;
+
+	if(_record && toRet != Board::Player::NONE) {
+		_record->end(toRet);
+		_record = nullptr;
+	}
 	
 	return toRet;
 }
+
+void Game::record(GameRecordWriter& w, const std::string& p1, const std::string& p2) {
+	for(size_t x = 0; x < _board.width(); x++) {
+		if(_board(x, 0) != Board::Player::E) {
+			throw std::invalid_argument("Can only record games from an empty board");
+		}
+	}
+	if(_toMove != Board::Player::P1) {
+		throw std::invalid_argument("Recorded games start with P1 to move");
+	}
+	if(_board.winLength() != 4) {
+		throw std::invalid_argument("Only connect four games can be recorded");
+	}
+
+	w.begin(_board.width(), _board.height(), p1, p2);
+	_record = &w;
+}
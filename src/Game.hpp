@@ -1,9 +1,11 @@
 #pragma once
 
 #include "Board.hpp"
+#include "GameRecord.hpp"
 #include "Player.hpp"
 
 #include <memory>
+#include <string>
 #include <vector>
 
 class Game {
@@ -19,9 +21,15 @@ public:
 
 	Board::Player step();
 
+	//! Records the game into w as it's played, under the given player
+	//! names. The board must still be empty. w has to outlive the game.
+	//! Throws std::invalid_argument if the game can't be recorded.
+	void record(GameRecordWriter& w, const std::string& p1, const std::string& p2);
+
 private:
 	Board _board;
 	std::unique_ptr<Player> _p1;
 	std::unique_ptr<Player> _p2;
 	Board::Player _toMove;
+	GameRecordWriter* _record;
 };
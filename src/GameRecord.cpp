@@ -0,0 +1,193 @@
+#include "GameRecord.hpp"
+#include "Board.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+static const char MAGIC[4] = { 'C', '4', 'G', 'R' };
+static const unsigned char VERSION = 1;
+static const size_t FILE_HEADER_SIZE = 8;
+static const size_t RECORD_HEADER_SIZE = 7;
+static const size_t MAX_NAME = 255;
+static const size_t MAX_MOVES = 65535;
+
+GameRecordWriter::GameRecordWriter(const std::string& path)
+	: _out(path, std::ios::binary | std::ios::trunc), _record(), _moves(0), _games(0), _open(false)
+{
+	if(!_out) {
+		throw std::runtime_error("Can't write game records " + path);
+	}
+
+	const char header[FILE_HEADER_SIZE] = { MAGIC[0], MAGIC[1], MAGIC[2], MAGIC[3], char(VERSION), 0, 0, 0 };
+	_out.write(header, FILE_HEADER_SIZE);
+}
+
+void GameRecordWriter::begin(size_t width, size_t height, const std::string& p1, const std::string& p2) {
+	if(width == 0 || width > MAX_WIDTH || height == 0 || height > 255) {
+		throw std::invalid_argument("Board too big to record");
+	}
+
+	size_t l1 = std::min(p1.size(), MAX_NAME);
+	size_t l2 = std::min(p2.size(), MAX_NAME);
+
+	_record.assign(RECORD_HEADER_SIZE, 0);
+	_record[0] = width;
+	_record[1] = height;
+	_record[3] = l1;
+	_record[4] = l2;
+	_record.insert(_record.end(), p1.begin(), p1.begin() + l1);
+	_record.insert(_record.end(), p2.begin(), p2.begin() + l2);
+
+	_moves = 0;
+	_open = true;
+}
+
+void GameRecordWriter::move(size_t x) {
+	if(!_open) {
+		return;
+	}
+	if(x >= _record[0] || _moves == MAX_MOVES) {
+		throw std::invalid_argument("Can't record move");
+	}
+
+	if(_moves % 2 == 0) {
+		_record.push_back(x);
+	} else {
+		_record.back() |= x << 4;
+	}
+	_moves++;
+}
+
+void GameRecordWriter::end(Board::Player result) {
+	if(!_open) {
+		return;
+	}
+
+	_record[2] = (unsigned char)result;
+	_record[5] = _moves & 0xFF;
+	_record[6] = _moves >> 8;
+	_out.write(reinterpret_cast<const char*>(_record.data()), _record.size());
+
+	_open = false;
+	_games++;
+}
+
+size_t GameRecordWriter::games() const {
+	return _games;
+}
+
+void GameRecordWriter::flush() {
+	_out.flush();
+	if(!_out) {
+		throw std::runtime_error("Failed writing game records");
+	}
+}
+
+GameRecord::GameRecord(const unsigned char* p)
+	: _p(p)
+{}
+
+size_t GameRecord::width() const {
+	return _p[0];
+}
+
+size_t GameRecord::height() const {
+	return _p[1];
+}
+
+Board::Player GameRecord::result() const {
+	return Board::Player(_p[2]);
+}
+
+std::string GameRecord::player1() const {
+	return std::string(reinterpret_cast<const char*>(_p) + RECORD_HEADER_SIZE, _p[3]);
+}
+
+std::string GameRecord::player2() const {
+	return std::string(reinterpret_cast<const char*>(_p) + RECORD_HEADER_SIZE + _p[3], _p[4]);
+}
+
+size_t GameRecord::moves() const {
+	return _p[5] | size_t(_p[6]) << 8;
+}
+
+const unsigned char* GameRecord::movesData() const {
+	return _p + RECORD_HEADER_SIZE + _p[3] + _p[4];
+}
+
+size_t GameRecord::move(size_t i) const {
+	unsigned char b = movesData()[i / 2];
+	return i % 2 == 0 ? b & 0xF : b >> 4;
+}
+
+size_t GameRecord::size() const {
+	return RECORD_HEADER_SIZE + _p[3] + _p[4] + (moves() + 1) / 2;
+}
+
+Board GameRecord::replay(size_t plies) const {
+	Board b(width(), height());
+	plies = std::min(plies, moves());
+
+	Board::Player p = Board::Player::P1;
+	for(size_t i = 0; i < plies; i++) {
+		size_t x = move(i);
+		if(x >= b.width() || b.isColumnFull(x) || b.winner() != Board::Player::E) {
+			throw std::runtime_error("Illegal move in game record");
+		}
+
+		b.put(p, x);
+		p = p == Board::Player::P1 ? Board::Player::P2 : Board::Player::P1;
+	}
+
+	return b;
+}
+
+GameRecordFile::iterator::iterator(const unsigned char* p, const unsigned char* end)
+	: _p(p), _end(end)
+{
+	if(_p == _end) {
+		return;
+	}
+
+	//make sure the whole record is there before anyone looks at it
+	size_t left = _end - _p;
+	if(left < RECORD_HEADER_SIZE || left < GameRecord(_p).size()) {
+		throw std::runtime_error("Truncated game record");
+	}
+}
+
+GameRecord GameRecordFile::iterator::operator*() const {
+	return GameRecord(_p);
+}
+
+GameRecordFile::iterator& GameRecordFile::iterator::operator++() {
+	*this = iterator(_p + GameRecord(_p).size(), _end);
+	return *this;
+}
+
+bool GameRecordFile::iterator::operator==(const iterator& o) const {
+	return _p == o._p;
+}
+
+bool GameRecordFile::iterator::operator!=(const iterator& o) const {
+	return _p != o._p;
+}
+
+GameRecordFile::GameRecordFile(const std::string& path)
+	: _file(path)
+{
+	if(_file.size() < FILE_HEADER_SIZE || std::memcmp(_file.data(), MAGIC, 4) != 0 || _file.data()[4] != VERSION) {
+		throw std::runtime_error("Not a game record file: " + path);
+	}
+}
+
+GameRecordFile::iterator GameRecordFile::begin() const {
+	return iterator(_file.data() + FILE_HEADER_SIZE, _file.data() + _file.size());
+}
+
+GameRecordFile::iterator GameRecordFile::end() const {
+	const unsigned char* e = _file.data() + _file.size();
+	return iterator(e, e);
+}
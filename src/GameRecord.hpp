@@ -0,0 +1,122 @@
+#pragma once
+
+#include "Board.hpp"
+#include "MappedFile.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+//! Compact binary game records.
+//!
+//! File layout, all integers little endian:
+//!   header   "C4GR", u8 version, 3 reserved bytes
+//!   records  { u8 width, u8 height, u8 result, u8 name1 length,
+//!              u8 name2 length, u16 moves, name1, name2,
+//!              (moves + 1) / 2 bytes of moves }
+//!
+//! Every game starts from an empty board with P1 to move. Moves are
+//! columns packed two to a byte, the earlier move in the low nibble, so
+//! boards are at most MAX_WIDTH wide. result is a Board::Player: the
+//! winner, E for a draw or NONE if the game was left unfinished.
+
+//! Appends games to a record file as they are played
+class GameRecordWriter {
+public:
+	static const size_t MAX_WIDTH = 16;
+
+	//! Truncates path. Throws std::runtime_error if it can't be written.
+	explicit GameRecordWriter(const std::string& path);
+
+	//! Starts recording a game between two named players. A game that
+	//! was begun but never ended is dropped. Throws
+	//! std::invalid_argument if the board is wider than MAX_WIDTH.
+	void begin(size_t width, size_t height, const std::string& p1, const std::string& p2);
+
+	void move(size_t x);
+
+	//! Writes out the current game with its result
+	void end(Board::Player result);
+
+	//! Games written so far
+	size_t games() const;
+
+	//! Throws std::runtime_error if anything failed to be written
+	void flush();
+
+private:
+	std::ofstream _out;
+	std::vector<unsigned char> _record;
+	size_t _moves;
+	size_t _games;
+	bool _open;
+};
+
+//! View of one record inside a GameRecordFile
+class GameRecord {
+public:
+	size_t width() const;
+	size_t height() const;
+	Board::Player result() const;
+	std::string player1() const;
+	std::string player2() const;
+
+	size_t moves() const;
+	//! Column played on ply i
+	size_t move(size_t i) const;
+
+	//! Board after the first plies moves, all of them by default.
+	//! Throws std::runtime_error if the record holds an illegal move.
+	Board replay(size_t plies = size_t(-1)) const;
+
+	//! Bytes taken by the record
+	size_t size() const;
+
+private:
+	friend class GameRecordFile;
+	explicit GameRecord(const unsigned char* p);
+
+	const unsigned char* movesData() const;
+
+	const unsigned char* _p;
+};
+
+//! Read-only, memory mapped file of game records. Records are read in
+//! place, nothing is parsed until it's asked for.
+class GameRecordFile {
+public:
+	class iterator {
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef GameRecord value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const GameRecord* pointer;
+		typedef GameRecord reference;
+
+		GameRecord operator*() const;
+		iterator& operator++();
+		bool operator==(const iterator& o) const;
+		bool operator!=(const iterator& o) const;
+
+	private:
+		friend class GameRecordFile;
+		iterator(const unsigned char* p, const unsigned char* end);
+
+		const unsigned char* _p;
+		const unsigned char* _end;
+	};
+
+	//! Throws std::runtime_error if path can't be opened or isn't a
+	//! record file
+	explicit GameRecordFile(const std::string& path);
+
+	//! Throw std::runtime_error on reaching a truncated record
+	iterator begin() const;
+	iterator end() const;
+
+private:
+	MappedFile _file;
+};
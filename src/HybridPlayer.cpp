@@ -1,20 +1,190 @@
 #include "HybridPlayer.hpp"
-#include "RandomPlayer.hpp"
+#include "BatchRollout.hpp"
 #include "Board.hpp"
-#include "Game.hpp"
+#include "MoveList.hpp"
+#include "BitBoard.hpp"
+#include "Confidence.hpp"
+#include "Random.hpp"
+#include "Rollout.hpp"
+#include "SearchStats.hpp"
+#include "TranspositionTable.hpp"
+#include "Solver.hpp"
+#include "ThreadPool.hpp"
 
 #include <iostream>
+#include <algorithm>
 #include <vector>
 #include <memory>
 #include <stdexcept>
+#include <chrono>
+#include <cmath>
 
-HybridPlayer::HybridPlayer(size_t maxGames, size_t minimaxDepth)
-	: _maxGames(maxGames), _mmDepth(minimaxDepth)
+HybridPlayer::HybridPlayer(size_t maxGames, size_t minimaxDepth, size_t ttMegabytes)
+	: _maxGames(maxGames), _mmDepth(minimaxDepth), _budget(0),
+	  _tt(new TranspositionTable(ttMegabytes)), _evaluate(false), _eval(),
+	  _solver(), _solverThreshold(SOLVER_THRESHOLD), _earlyStop(EARLY_STOP_DELTA)
 {}
 
-static float minimax(Board& b, size_t lvl, float alpha, float beta, Board::Player p, Board::Player current);
+HybridPlayer::HybridPlayer(std::chrono::milliseconds budget, size_t ttMegabytes)
+	: _maxGames(0), _mmDepth(0), _budget(budget),
+	  _tt(new TranspositionTable(ttMegabytes)), _evaluate(false), _eval(),
+	  _solver(), _solverThreshold(SOLVER_THRESHOLD), _earlyStop(EARLY_STOP_DELTA)
+{
+	setBudget(budget);
+}
+
+void HybridPlayer::setBudget(std::chrono::milliseconds budget) {
+	if(budget.count() <= 0) {
+		throw std::invalid_argument("Time budget must be positive");
+	}
+	_budget = budget;
+}
+
+void HybridPlayer::setSolverThreshold(size_t emptyCells) {
+	_solverThreshold = emptyCells;
+}
+
+void HybridPlayer::setEarlyStop(double delta) {
+	if(delta < 0 || delta >= 1) {
+		throw std::invalid_argument("Early stop delta must be in [0, 1)");
+	}
+	_earlyStop = delta;
+}
+
+void HybridPlayer::setEvaluation(bool on) {
+	//entries scored one way would mix with ones scored the other
+	if(on != _evaluate) {
+		_tt->clear();
+	}
+	_evaluate = on;
+}
+
+const Evaluator* HybridPlayer::evaluator(const Board& b) {
+	if(!_evaluate || !BitBoard::fits(b.width(), b.height()) || b.winLength() != 4) {
+		return nullptr;
+	}
+
+	if(!_eval || _eval->width() != b.width() || _eval->height() != b.height()) {
+		_eval.reset(new Evaluator(b.width(), b.height()));
+	}
+	return _eval.get();
+}
+
+namespace {
+
+//! Lets a timed search give up once the clock runs out. The clock is
+//! only read every 1024 nodes.
+struct Deadline {
+	std::chrono::steady_clock::time_point at;
+	size_t nodes;
+	bool expired;
+
+	bool check() {
+		if(!expired && (++nodes & 1023) == 0) {
+			expired = std::chrono::steady_clock::now() >= at;
+		}
+		return expired;
+	}
+};
+
+//! Scores minimax leaves with eval, on a BitBoard the search keeps in
+//! step with its Board so that no leaf has to convert one, or as draws
+//! without an evaluator
+struct Leaves {
+	const Evaluator* eval;
+	BitBoard bits;
+
+	Leaves(const Evaluator* e, const Board& b)
+		: eval(e), bits(e ? BitBoard(b) : BitBoard(1, 1))
+	{}
+
+	void put(Board::Player p, size_t x) {
+		if(eval) {
+			bits.put(p, x);
+		}
+	}
+
+	void unput(size_t x) {
+		if(eval) {
+			bits.unput(x);
+		}
+	}
+
+	float score(Board::Player p, Board::Player toMove) const {
+		return eval ? eval->evaluate(bits, p, toMove) : 0;
+	}
+};
+
+//! Part of the rollouts of one root move, run as a single pool task
+struct Chunk {
+	size_t move;
+	size_t games;
+	float score;
+};
+
+}
+
+static float minimax(Board& b, size_t lvl, float alpha, float beta, Board::Player p, Board::Player current, TranspositionTable& tt, SearchCounters& c, Leaves& leaves, Deadline* dl = nullptr);
+
+//! Value of a move from its minimax score and its rollouts, see
+//! HybridPlayer::setEvaluation
+static float blend(float mm, float rollScore, size_t rollGames, bool eval) {
+	if(std::isinf(mm) || rollGames == 0) {
+		return mm;
+	}
+
+	float mean = rollScore / rollGames;
+	return eval ? (mm + mean) / 2 : mean;
+}
+
+//! Games per pool task
+static const size_t ROLLOUT_CHUNK = 512;
+
+//! Plays that many random games from moved with o to move. Returns
+//! wins minus losses from the point of view of p.
+static float rollouts(const Board& moved, Board::Player p, Board::Player o, size_t games) {
+	static thread_local XorShift gen(randomSeed());
+
+	if(BitBoard::fits(moved.width(), moved.height()) && moved.winLength() == 4) {
+		RolloutCounts r = batchRollouts(BitBoard(moved), p, o, games, gen);
+		return float(r.wins) - float(r.losses);
+	}
+
+	return boardRollouts(moved, p, o, games, gen);
+}
+
+//! The calling thread's own board, set to b. Assigning reuses its
+//! storage, so pool tasks can search and roll out with put/unput and
+//! never allocate.
+static Board& scratch(const Board& b) {
+	static thread_local Board s(1, 1);
+	s = b;
+	return s;
+}
+
+//! Makes move x on the calling thread's scratch board and passes it on
+static Board& scratch(const Board& b, Board::Player p, size_t x) {
+	Board& s = scratch(b);
+	s.put(p, x);
+	return s;
+}
+
+const SearchStats* HybridPlayer::lastStats() const {
+	return &_stats;
+}
 
 size_t HybridPlayer::makeMove(const Board& b, Board::Player p) {
+	auto start = std::chrono::steady_clock::now();
+	_stats.clear();
+
+	size_t move = search(b, p);
+
+	_stats.move = move;
+	_stats.totalSeconds = secondsSince(start);
+	return move;
+}
+
+size_t HybridPlayer::search(const Board& b, Board::Player p) {
 	if(p == Board::Player::E) {
 		throw std::invalid_argument("Passed E as player");
 	}
@@ -25,70 +195,319 @@ size_t HybridPlayer::makeMove(const Board& b, Board::Player p) {
 	if(moves.size() == 0) {
 		throw std::invalid_argument("No legal moves available");
 	}
-	std::vector<float> scores(moves.size());
 
+	size_t solved;
+	if(solveEndgame(_solver, b, p, _solverThreshold, solved, &_stats)) {
+		return solved;
+	}
+
+	_tt->newSearch();
+	if(_budget.count() > 0) {
+		return timedMove(b, p);
+	}
+
+	const Evaluator* eval = evaluator(b);
+	std::vector<float> scores(moves.size());
+	std::vector<float> rolls(moves.size(), 0);
 	size_t gamesPerMove = _maxGames / moves.size();
-	
-	#pragma omp parallel for
-	for(size_t move = 0; move < moves.size(); move++) {
-		float score = 0;
-
-		Board moved(b);
-		size_t t = moved.put(p, moves[move]);
-		if(causedWin(moved, moves[move], t)) {
-			scores[move] = gamesPerMove;
-			continue;
-		} else if(moved.isFull()) {
-			continue;
-		}
-
-		float mmScore = minimax(moved, _mmDepth, -1.0/0.0, 1.0/0.0, p, o);
-		if(mmScore == 1.0 / 0.0) {
-			scores[move] = mmScore;
-			continue;
-		} else if(mmScore != 0) {
-			scores[move] = mmScore;
-			continue;
-		}
-		
-		Game g(moved, std::unique_ptr<Player>(new RandomPlayer()), std::unique_ptr<Player>(new RandomPlayer()));
-
-		for(size_t i = 0; i < gamesPerMove; i++) {
-			g.board() = moved;
-			g.toMove() = o;
-			
-			Board::Player winner;
-
-			while((winner = g.step()) == Board::Player::NONE);
-
-			if(winner == p) {
-				score++;
-			} else if(winner == o) {
-				score--;
-			}
+	_stats.rootPlayouts.assign(b.width(), 0);
+	_stats.depth = _mmDepth;
+
+	//moves that neither win right away nor fill the board
+	std::vector<char> open(moves.size(), 0);
+	Board& work = scratch(b);
+	for(size_t i = 0; i < moves.size(); i++) {
+		size_t t = work.put(p, moves[i]);
+		if(causedWin(work, moves[i], t)) {
+			scores[i] = 1.0 / 0.0;
+		} else if(!work.isFull()) {
+			open[i] = 1;
+		}
+		work.unput(moves[i]);
+	}
+
+	ThreadPool& pool = ThreadPool::shared();
+	auto start = std::chrono::steady_clock::now();
+
+	std::vector<SearchCounters> counters(moves.size());
+	pool.parallelFor(moves.size(), [&](size_t i) {
+		if(open[i]) {
+			Board& work = scratch(b, p, moves[i]);
+			Leaves leaves(eval, work);
+			scores[i] = minimax(work, _mmDepth, -1.0/0.0, 1.0/0.0, p, o, *_tt, counters[i], leaves);
 		}
+	});
 
-		scores[move] = score;
+	for(const SearchCounters& c : counters) {
+		_stats.counters += c;
 	}
+	_stats.searchSeconds = secondsSince(start);
+	start = std::chrono::steady_clock::now();
+
+	//moves minimax couldn't prove anything about get rollouts, split
+	//into chunks that idle threads can take over. The moves take turns,
+	//so every wave of chunks moves them all on.
+	std::vector<size_t> rolled;
+	for(size_t i = 0; i < moves.size(); i++) {
+		if(open[i] && !std::isinf(scores[i]) && gamesPerMove != 0) {
+			rolled.push_back(i);
+		}
+	}
+
+	std::vector<Chunk> chunks;
+	for(size_t done = 0; done < gamesPerMove && !rolled.empty(); done += ROLLOUT_CHUNK) {
+		for(size_t i : rolled) {
+			chunks.push_back({ i, std::min(ROLLOUT_CHUNK, gamesPerMove - done), 0 });
+		}
+	}
+
+	//every move's value so far, with an early stop. delta is shared out
+	//over every move and check.
+	size_t checks = 0;
+	auto estimates = [&]() {
+		const double delta = checkDelta(_earlyStop, moves.size(), ++checks);
+		std::vector<Estimate> e;
+		for(size_t i = 0; i < moves.size(); i++) {
+			size_t n = _stats.rootPlayouts[moves[i]];
+			float r = hoeffdingRadius(n, delta);
+			bool exact = std::find(rolled.begin(), rolled.end(), i) == rolled.end();
+			e.push_back({ blend(scores[i], rolls[i], n, eval), exact ? 0 : eval ? r / 2 : r });
+		}
+		return e;
+	};
+
+	const size_t wave = _earlyStop > 0 ? pool.size() : chunks.size();
+	bool decided = _earlyStop > 0 && separated(estimates());
+	for(size_t first = 0; first < chunks.size() && !decided; first += wave) {
+		const size_t n = std::min(wave, chunks.size() - first);
+		pool.parallelFor(n, [&](size_t c) {
+			Chunk& chunk = chunks[first + c];
+			chunk.score = rollouts(scratch(b, p, moves[chunk.move]), p, o, chunk.games);
+		});
+
+		for(size_t c = first; c < first + n; c++) {
+			rolls[chunks[c].move] += chunks[c].score;
+			_stats.rootPlayouts[moves[chunks[c].move]] += chunks[c].games;
+			_stats.counters.playouts += chunks[c].games;
+		}
+
+		decided = _earlyStop > 0 && separated(estimates());
+	}
+	_stats.rolloutSeconds = secondsSince(start);
 
 	float best = -1.0 / 0.0;
 	size_t bestMove = -1;
 	for(size_t i = 0; i < scores.size(); i++) {
-		if(scores[i] >= best) {
-			best = scores[i];
+		float v = blend(scores[i], rolls[i], _stats.rootPlayouts[moves[i]], eval);
+		if(v >= best) {
+			best = v;
 			bestMove = moves[i];
 		}
 	}
 
+	//proven results are infinite
+	_stats.score = std::isinf(best) ? (best > 0 ? 1 : -1) : best;
+
 	return bestMove;
 }
 
-static float minimax(Board& b, size_t lvl, float alpha, float beta, Board::Player p, Board::Player current) {
+size_t HybridPlayer::timedMove(const Board& b, Board::Player p) {
+	//games per move between two deepening iterations
+	const size_t ROLLOUT_ROUND = 256;
+
+	Board::Player o = p == Board::Player::P1 ? Board::Player::P2 : Board::Player::P1;
+	Deadline dl = { std::chrono::steady_clock::now() + _budget, 0, false };
+
+	//the minimax iterations all run on work, with put/unput
+	const std::vector<size_t>& moves = b.legalMoves();
+	Board work(b);
+	std::vector<char> full(moves.size(), 0);
+	for(size_t i = 0; i < moves.size(); i++) {
+		size_t t = work.put(p, moves[i]);
+		if(causedWin(work, moves[i], t)) {
+			_stats.score = 1;
+			return moves[i];
+		}
+		full[i] = work.isFull();
+		work.unput(moves[i]);
+	}
+
+	//minimax results of the last completed iteration, and rollout
+	//totals that keep accumulating across iterations
+	std::vector<float> mm(moves.size(), 0);
+	std::vector<float> rollScore(moves.size(), 0);
+	std::vector<size_t> rollGames(moves.size(), 0);
+	_stats.rootPlayouts.assign(b.width(), 0);
+
+	const Evaluator* eval = evaluator(b);
+	Leaves leaves(eval, work);
+	auto mean = [&](size_t i) {
+		return rollGames[i] ? rollScore[i] / rollGames[i] : 0.0f;
+	};
+	auto value = [&](size_t i) {
+		return blend(mm[i], rollScore[i], rollGames[i], eval);
+	};
+	auto better = [&](size_t i, size_t j) {
+		return value(i) != value(j) ? value(i) > value(j) : mean(i) > mean(j);
+	};
+
+	//true while some move could still use rollouts
+	auto undecided = [&]() {
+		for(size_t i = 0; i < moves.size(); i++) {
+			if(!std::isinf(mm[i]) && !full[i]) {
+				return true;
+			}
+		}
+		return false;
+	};
+
+	auto rolloutRound = [&]() {
+		auto start = std::chrono::steady_clock::now();
+
+		ThreadPool::shared().parallelFor(moves.size(), [&](size_t i) {
+			if(!std::isinf(mm[i]) && !full[i]) {
+				rollScore[i] += rollouts(scratch(b, p, moves[i]), p, o, ROLLOUT_ROUND);
+				rollGames[i] += ROLLOUT_ROUND;
+			}
+		});
+
+		_stats.rolloutSeconds += secondsSince(start);
+	};
+
+	//answers with moves[i] and fills in the playout counts
+	auto finish = [&](size_t i) {
+		for(size_t j = 0; j < moves.size(); j++) {
+			_stats.rootPlayouts[moves[j]] = rollGames[j];
+			_stats.counters.playouts += rollGames[j];
+		}
+		_stats.score = std::isinf(mm[i]) ? (mm[i] > 0 ? 1 : -1) : value(i);
+		return moves[i];
+	};
+
+	//best first, from the previous iteration
+	std::vector<size_t> order(moves.size());
+	for(size_t i = 0; i < order.size(); i++) {
+		order[i] = i;
+	}
+
+	size_t empty = b.width() * b.height();
+	for(size_t x = 0; x < b.width(); x++) {
+		for(size_t y = 0; y < b.height() && b(x, y) != Board::Player::E; y++) {
+			empty--;
+		}
+	}
+
+	for(size_t depth = 1; depth < empty && !dl.expired; depth++) {
+		std::vector<float> iter(mm);
+		auto start = std::chrono::steady_clock::now();
+
+		for(size_t i : order) {
+			//proven results don't change with depth
+			if(std::isinf(iter[i]) || full[i]) {
+				continue;
+			}
+
+			work.put(p, moves[i]);
+			leaves.put(p, moves[i]);
+			iter[i] = minimax(work, depth, -1.0/0.0, 1.0/0.0, p, o, *_tt, _stats.counters, leaves, &dl);
+			leaves.unput(moves[i]);
+			work.unput(moves[i]);
+			if(dl.expired) {
+				break;
+			}
+		}
+
+		_stats.searchSeconds += secondsSince(start);
+		if(dl.expired) {
+			break;
+		}
+
+		mm = iter;
+		_stats.depth = depth;
+		for(size_t i = 0; i < moves.size(); i++) {
+			if(mm[i] == 1.0 / 0.0) {
+				return finish(i);
+			}
+		}
+
+		//once every move is proven or fills the board, neither deeper
+		//searches nor rollouts change anything
+		if(!undecided()) {
+			break;
+		}
+
+		std::stable_sort(order.begin(), order.end(), better);
+		rolloutRound();
+	}
+
+	//the loop only ends before the deadline once every move is decided
+	//or has been searched to the end, the rest of the budget is saved
+
+	size_t best = 0;
+	for(size_t i = 1; i < moves.size(); i++) {
+		if(better(i, best)) {
+			best = i;
+		}
+	}
+
+	return finish(best);
+}
+
+//! Alpha-beta from the point of view of p. Table entries are stored
+//! from the point of view of the player to move, so they stay valid
+//! whichever side the player is on. Moves go to leaves too, which
+//! scores the horizon. Once dl expires the result is meaningless and
+//! nothing more is stored. Moves holds the columns of a node, see
+//! minimax.
+template<class Moves>
+static float minimaxWith(Board& b, size_t lvl, float alpha, float beta, Board::Player p, Board::Player current, TranspositionTable& tt, SearchCounters& c, Leaves& leaves, Deadline* dl) {
+	c.nodes++;
 	if(lvl == 0) {
+		return leaves.score(p, current);
+	}
+	if(dl && dl->check()) {
 		return 0;
 	}
+
+	//window and results seen by current
+	float sign = current == p ? 1.0f : -1.0f;
+	float lo = current == p ? alpha : -beta;
+	float hi = current == p ? beta  : -alpha;
+	const float loOrig = lo;
+	const float hiOrig = hi;
+
+	size_t ttMove = b.width();
+	TranspositionTable::Entry e;
+	c.ttProbes++;
+	if(tt.probe(b.hash(), e)) {
+		c.ttHits++;
+		ttMove = e.move;
+
+		if(e.depth >= lvl) {
+			if(e.bound == TranspositionTable::Bound::EXACT) {
+				return sign * e.value;
+			} else if(e.bound == TranspositionTable::Bound::LOWER) {
+				lo = std::max(lo, e.value);
+			} else if(e.bound == TranspositionTable::Bound::UPPER) {
+				hi = std::min(hi, e.value);
+			}
+
+			if(lo >= hi) {
+				return sign * e.value;
+			}
+
+			alpha = current == p ? lo : -hi;
+			beta  = current == p ? hi : -lo;
+		}
+	}
 	
-	std::vector<size_t> legalMoves = b.legalMoves();
+	//the table's move first and then center first
+	Moves legalMoves;
+	centerFirstMoves(b, ttMove, legalMoves);
+
+	Board::Player next = current == Board::Player::P1 ? Board::Player::P2 : Board::Player::P1;
+	float result;
+	size_t bestMove = legalMoves.empty() ? 0 : legalMoves[0];
 
 	if(current == p) {
 		float best = -1.0 / 0.0; // -inf
@@ -96,36 +515,88 @@ static float minimax(Board& b, size_t lvl, float alpha, float beta, Board::Playe
 			size_t y = b.put(current, move);
 			if(causedWin(b, move, y)) {
 				best = 1.0 / 0.0;
+				bestMove = move;
 				b.unput(move);
 				break;
 			}
 
-			best = std::max(best, minimax(b, lvl-1, alpha, beta, p, current == Board::Player::P1 ? Board::Player::P2 : Board::Player::P1));
+			leaves.put(current, move);
+			float score = minimaxWith<Moves>(b, lvl-1, alpha, beta, p, next, tt, c, leaves, dl);
+			leaves.unput(move);
+			if(dl && dl->expired) {
+				b.unput(move);
+				return 0;
+			}
+			if(score > best) {
+				best = score;
+				bestMove = move;
+			}
 			alpha = std::max(alpha, best);
 			b.unput(move);
 
-			if(beta <= alpha) break;
+			if(beta <= alpha) {
+				c.cutoffs++;
+				break;
+			}
 		}
 
-		return best;
+		result = best;
 	} else {
 		float worst = 1.0 / 0.0; // +inf
 		for(size_t move : legalMoves) {
 			size_t y = b.put(current, move);
 			if(causedWin(b, move, y)) {
 				worst = -1.0 / 0.0;
+				bestMove = move;
 				b.unput(move);
 				break;
 			}
 
-			worst = std::min(worst, minimax(b, lvl-1, alpha, beta, p, current == Board::Player::P1 ? Board::Player::P2 : Board::Player::P1));
+			leaves.put(current, move);
+			float score = minimaxWith<Moves>(b, lvl-1, alpha, beta, p, next, tt, c, leaves, dl);
+			leaves.unput(move);
+			if(dl && dl->expired) {
+				b.unput(move);
+				return 0;
+			}
+			if(score < worst) {
+				worst = score;
+				bestMove = move;
+			}
 			beta = std::min(beta, worst);
 			b.unput(move);
 
-			if(beta <= alpha) break;
+			if(beta <= alpha) {
+				c.cutoffs++;
+				break;
+			}
 		}
 
-		return worst;
+		result = worst;
 	}
+
+	if(legalMoves.empty()) {
+		//full board, a draw
+		result = 0;
+	}
+
+	float value = sign * result;
+	e.value = value;
+	e.depth = std::min<size_t>(lvl, 255);
+	e.bound = value <= loOrig ? TranspositionTable::Bound::UPPER :
+	          value >= hiOrig ? TranspositionTable::Bound::LOWER :
+	                            TranspositionTable::Bound::EXACT;
+	e.move  = bestMove;
+	tt.store(b.hash(), e);
+
+	return result;
 }
 
+//! Keeps the move lists on the stack unless b is too wide for a MoveList
+static float minimax(Board& b, size_t lvl, float alpha, float beta, Board::Player p, Board::Player current, TranspositionTable& tt, SearchCounters& c, Leaves& leaves, Deadline* dl) {
+	if(b.width() <= 64) {
+		return minimaxWith<MoveList>(b, lvl, alpha, beta, p, current, tt, c, leaves, dl);
+	}
+
+	return minimaxWith<std::vector<size_t>>(b, lvl, alpha, beta, p, current, tt, c, leaves, dl);
+}
@@ -1,13 +1,61 @@
 #pragma once
 
+#include "Evaluator.hpp"
 #include "Player.hpp"
+#include "SearchStats.hpp"
+#include "Solver.hpp"
+#include "TranspositionTable.hpp"
+
+#include <chrono>
+#include <memory>
 
 class HybridPlayer : public Player {
 public:
-	HybridPlayer(size_t maxGames, size_t minimaxDepth);
+	//! Searches minimaxDepth plies, then splits maxGames rollouts
+	//! over the moves minimax couldn't decide
+	HybridPlayer(size_t maxGames, size_t minimaxDepth, size_t ttMegabytes = 16);
+	//! Deepens the search one ply at a time, with rollouts in between,
+	//! and answers with the best move found when the budget runs out, or
+	//! as soon as every move is proven or searched to the end
+	explicit HybridPlayer(std::chrono::milliseconds budget, size_t ttMegabytes = 16);
 	virtual size_t makeMove(const Board& b, Board::Player p);
+	virtual const SearchStats* lastStats() const;
+
+	//! Hands over to the exact Solver once at most emptyCells cells are
+	//! left, 0 turns it off
+	void setSolverThreshold(size_t emptyCells);
+
+	//! Switches to (or stays in) timed mode with a new budget, keeping
+	//! the transposition table
+	void setBudget(std::chrono::milliseconds budget);
+
+	//! Scores minimax leaves with an Evaluator instead of as draws, on
+	//! boards that fit in a BitBoard. A move's value is then the
+	//! average of its minimax score and its rollout mean, or the
+	//! minimax score alone if it got no rollouts. Changing it clears
+	//! the transposition table.
+	void setEvaluation(bool on);
+
+	//! Same as MonteCarloPlayer::setEarlyStop, a proven win stops the
+	//! rollouts outright. Timed searches use their whole budget.
+	void setEarlyStop(double delta);
 
 private:
+	size_t search(const Board& b, Board::Player p);
+	size_t timedMove(const Board& b, Board::Player p);
+	//! Evaluator for b, nullptr if leaves are scored as draws
+	const Evaluator* evaluator(const Board& b);
+
 	size_t _maxGames;
 	size_t _mmDepth;
+	std::chrono::milliseconds _budget;
+	std::unique_ptr<TranspositionTable> _tt;
+	SearchStats _stats;
+
+	bool _evaluate;
+	std::unique_ptr<Evaluator> _eval;
+
+	std::unique_ptr<Solver> _solver;
+	size_t _solverThreshold;
+	double _earlyStop;
 };
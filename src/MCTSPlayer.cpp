@@ -0,0 +1,363 @@
+#include "MCTSPlayer.hpp"
+#include "BitBoard.hpp"
+#include "Board.hpp"
+#include "Random.hpp"
+#include "Rollout.hpp"
+#include "SearchStats.hpp"
+#include "Solver.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+MCTSPlayer::MCTSPlayer(size_t maxPlayouts, size_t maxNodes, float exploration, size_t threads)
+	: _maxPlayouts(maxPlayouts), _maxNodes(maxNodes), _exploration(exploration),
+	  _threads(threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency())),
+	  _nodes(new Node[maxNodes]), _scratch(new Node[maxNodes]), _used(0), _remaining(0), _playouts(0),
+	  _root(1, 1), _rootToMove(Board::Player::P1), _hasTree(false),
+	  _solver(), _solverThreshold(SOLVER_THRESHOLD)
+{
+	if(maxNodes < 2 || maxNodes > UINT32_MAX / 2) {
+		throw std::invalid_argument("Node pool size out of range");
+	}
+}
+
+void MCTSPlayer::setSolverThreshold(size_t emptyCells) {
+	_solverThreshold = emptyCells;
+}
+
+void MCTSPlayer::Node::init(unsigned char m, Result r) {
+	firstChild = 0;
+	visits.store(0, std::memory_order_relaxed);
+	score.store(0, std::memory_order_relaxed);
+	numChildren.store(0, std::memory_order_relaxed);
+	expanding.clear(std::memory_order_relaxed);
+	move = m;
+	result = r;
+}
+
+void MCTSPlayer::Node::copyFrom(const Node& o) {
+	init(o.move, o.result);
+	firstChild = o.firstChild;
+	visits.store(o.visits.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	score.store(o.score.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	numChildren.store(o.numChildren.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+	//leaves that failed to expand on a full pool get another chance
+	if(o.numChildren.load(std::memory_order_relaxed) != 0) {
+		expanding.test_and_set(std::memory_order_relaxed);
+	}
+}
+
+static Board::Player other(Board::Player p) {
+	return p == Board::Player::P1 ? Board::Player::P2 : Board::Player::P1;
+}
+
+const SearchStats* MCTSPlayer::lastStats() const {
+	return &_stats;
+}
+
+size_t MCTSPlayer::makeMove(const Board& b, Board::Player p) {
+	auto start = std::chrono::steady_clock::now();
+	_stats.clear();
+
+	size_t move = search(b, p);
+
+	_stats.move = move;
+	_stats.totalSeconds = secondsSince(start);
+	return move;
+}
+
+size_t MCTSPlayer::search(const Board& b, Board::Player p) {
+	if(p == Board::Player::E) {
+		throw std::invalid_argument("Passed E as player");
+	}
+	if(b.legalMoves().empty()) {
+		throw std::invalid_argument("No legal moves available");
+	}
+	if(!BitBoard::fits(b.width(), b.height())) {
+		throw std::invalid_argument("Board too large for MCTSPlayer");
+	}
+
+	size_t solved;
+	if(solveEndgame(_solver, b, p, _solverThreshold, solved, &_stats)) {
+		return solved;
+	}
+
+	BitBoard bb(b);
+	if(!reuseTree(bb, p)) {
+		newTree(bb, p);
+	}
+
+	if(_nodes[0].numChildren == 0) {
+		BitBoard tmp(_root);
+		expand(0, tmp, p);
+
+		if(_nodes[0].numChildren == 0) {
+			//no room left in the pool at all
+			return b.legalMoves()[0];
+		}
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	uint32_t usedBefore = _used;
+	_playouts = 0;
+
+	_remaining = _maxPlayouts;
+	if(_threads > 1) {
+		std::vector<std::thread> workers;
+		for(size_t i = 1; i < _threads; i++) {
+			workers.emplace_back(&MCTSPlayer::work, this);
+		}
+		work();
+
+		for(auto& t : workers) {
+			t.join();
+		}
+	} else {
+		work();
+	}
+
+	const Node& root = _nodes[0];
+
+	_stats.searchSeconds = secondsSince(start);
+	_stats.counters.playouts = _playouts;
+	_stats.counters.nodes = std::min<uint32_t>(_used, _maxNodes) - usedBefore;
+	_stats.rootPlayouts.assign(b.width(), 0);
+	for(uint32_t c = root.firstChild; c < root.firstChild + root.numChildren; c++) {
+		_stats.rootPlayouts[_nodes[c].move] = _nodes[c].visits;
+	}
+
+	//the most visited move is the most robust choice, but a
+	//proven win always beats it
+	uint32_t best = root.firstChild;
+	for(uint32_t c = root.firstChild; c < root.firstChild + root.numChildren; c++) {
+		if(_nodes[c].result == Result::WIN) {
+			return _nodes[c].move;
+		}
+		if(_nodes[c].visits > _nodes[best].visits) {
+			best = c;
+		}
+	}
+
+	return _nodes[best].move;
+}
+
+void MCTSPlayer::work() {
+	uint64_t playouts = 0;
+	while(_remaining.fetch_sub(1, std::memory_order_relaxed) > 0) {
+		iterate();
+		playouts++;
+	}
+
+	_playouts.fetch_add(playouts, std::memory_order_relaxed);
+}
+
+void MCTSPlayer::newTree(const BitBoard& b, Board::Player p) {
+	_root = b;
+	_rootToMove = p;
+	_hasTree = true;
+
+	_used = 1;
+	_nodes[0].init(0, Result::UNKNOWN);
+}
+
+bool MCTSPlayer::reuseTree(const BitBoard& b, Board::Player p) {
+	if(!_hasTree || b.width() != _root.width() || b.height() != _root.height()) {
+		return false;
+	}
+
+	auto same = [&](const BitBoard& o) {
+		return o.position() == b.position() && o.mask() == b.mask();
+	};
+
+	if(p == _rootToMove && same(_root)) {
+		return true;
+	}
+
+	//look for the position two plies down, after our last move
+	//and the opponent's reply
+	const Node& root = _nodes[0];
+	for(uint32_t c = root.firstChild; c < root.firstChild + root.numChildren; c++) {
+		const Node& child = _nodes[c];
+
+		BitBoard moved(_root);
+		moved.put(_rootToMove, child.move);
+
+		for(uint32_t g = child.firstChild; g < child.firstChild + child.numChildren; g++) {
+			BitBoard replied(moved);
+			replied.put(other(_rootToMove), _nodes[g].move);
+
+			if(p == _rootToMove && same(replied)) {
+				compact(g);
+				_root = replied;
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+void MCTSPlayer::compact(uint32_t newRoot) {
+	//breadth first copy of the subtree into the scratch pool,
+	//each entry pairs a node in the old pool with its copy
+	std::vector<std::pair<uint32_t, uint32_t>> queue;
+	queue.emplace_back(newRoot, 0);
+	_scratch[0].copyFrom(_nodes[newRoot]);
+	uint32_t used = 1;
+
+	for(size_t i = 0; i < queue.size(); i++) {
+		const Node& from = _nodes[queue[i].first];
+		Node& to = _scratch[queue[i].second];
+
+		if(from.numChildren == 0) {
+			continue;
+		}
+
+		to.firstChild = used;
+		for(uint32_t c = 0; c < from.numChildren; c++) {
+			_scratch[used].copyFrom(_nodes[from.firstChild + c]);
+			queue.emplace_back(from.firstChild + c, used);
+			used++;
+		}
+	}
+
+	std::swap(_nodes, _scratch);
+	_used = used;
+}
+
+void MCTSPlayer::expand(uint32_t node, BitBoard& b, Board::Player toMove) {
+	Node& parent = _nodes[node];
+
+	//only one thread gets to expand a node, the others roll out from it
+	if(parent.expanding.test_and_set(std::memory_order_acquire)) {
+		return;
+	}
+
+	uint32_t n = 0;
+	for(size_t x = 0; x < b.width(); x++) {
+		n += !b.isColumnFull(x);
+	}
+
+	if(n == 0 || _used.load(std::memory_order_relaxed) + n > _maxNodes) {
+		return;
+	}
+
+	uint32_t first = _used.fetch_add(n, std::memory_order_relaxed);
+	if(first + n > _maxNodes) {
+		return;
+	}
+
+	uint32_t next = first;
+	for(size_t x = 0; x < b.width(); x++) {
+		if(b.isColumnFull(x)) {
+			continue;
+		}
+
+		size_t y = b.put(toMove, x);
+		Result r = causedWin(b, x, y) ? Result::WIN  :
+		           b.isFull()         ? Result::DRAW :
+		                                Result::UNKNOWN;
+		b.unput(x);
+
+		_nodes[next++].init(x, r);
+	}
+
+	parent.firstChild = first;
+	parent.numChildren.store(n, std::memory_order_release);
+}
+
+uint32_t MCTSPlayer::select(uint32_t node) const {
+	const Node& parent = _nodes[node];
+	unsigned n = parent.numChildren.load(std::memory_order_acquire);
+	float logN = std::log(float(parent.visits.load(std::memory_order_relaxed)));
+
+	uint32_t best = parent.firstChild;
+	float bestValue = -1.0f;
+	for(uint32_t c = parent.firstChild; c < parent.firstChild + n; c++) {
+		const Node& child = _nodes[c];
+		uint32_t visits = child.visits.load(std::memory_order_relaxed);
+		if(visits == 0) {
+			return c;
+		}
+
+		float mean = child.score.load(std::memory_order_relaxed) / (2.0f * visits);
+		float value = mean + _exploration * std::sqrt(logN / visits);
+		if(value > bestValue) {
+			bestValue = value;
+			best = c;
+		}
+	}
+
+	return best;
+}
+
+void MCTSPlayer::iterate() {
+	static thread_local XorShift gen(randomSeed());
+
+	uint32_t path[64 + 1];
+	size_t depth = 0;
+
+	BitBoard b(_root);
+	Board::Player toMove = _rootToMove;
+	uint32_t node = 0;
+	path[depth++] = node;
+	_nodes[node].visits.fetch_add(1, std::memory_order_relaxed);
+
+	//visits are counted on the way down (virtual loss), the
+	//score only once the playout is over
+	auto descend = [&]() {
+		node = select(node);
+		_nodes[node].visits.fetch_add(1, std::memory_order_relaxed);
+		b.put(toMove, _nodes[node].move);
+		toMove = other(toMove);
+		path[depth++] = node;
+	};
+
+	//selection
+	while(_nodes[node].numChildren.load(std::memory_order_acquire) != 0 && _nodes[node].result == Result::UNKNOWN) {
+		descend();
+	}
+
+	//expansion, a node is expanded on its second visit
+	if(_nodes[node].result == Result::UNKNOWN && _nodes[node].visits.load(std::memory_order_relaxed) > 1) {
+		expand(node, b, toMove);
+
+		if(_nodes[node].numChildren.load(std::memory_order_acquire) != 0) {
+			descend();
+		}
+	}
+
+	//simulation, winner is E on a draw
+	Board::Player winner;
+	switch(_nodes[node].result) {
+	case Result::WIN:
+		winner = other(toMove);
+		break;
+	case Result::DRAW:
+		winner = Board::Player::E;
+		break;
+	default:
+		winner = rollout(b, toMove, gen);
+		break;
+	}
+
+	//backpropagation, the node at depth i was entered by the player
+	//to move at the root if i is odd
+	for(size_t i = 0; i < depth; i++) {
+		Board::Player mover = i % 2 ? _rootToMove : other(_rootToMove);
+
+		uint32_t points = winner == mover            ? 2 :
+		                  winner == Board::Player::E ? 1 :
+		                                               0;
+		if(points) {
+			_nodes[path[i]].score.fetch_add(points, std::memory_order_relaxed);
+		}
+	}
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Player.hpp"
+#include "SearchStats.hpp"
+#include "Solver.hpp"
+#include "BitBoard.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+//! Monte Carlo Tree Search with UCT selection and random rollouts.
+//! The tree lives in a preallocated node pool and is kept between
+//! calls, so the subtree of the position reached after the opponent's
+//! reply is reused on the next move.
+//! With more than one thread all of them descend the same tree at once.
+//! Counters are atomic and a visit is counted on the way down, before
+//! its result is known, which acts as a virtual loss that steers the
+//! other threads towards different lines.
+class MCTSPlayer : public Player {
+public:
+	//! threads == 0 uses every hardware thread
+	MCTSPlayer(size_t maxPlayouts, size_t maxNodes = 1 << 20, float exploration = 1.41f, size_t threads = 1);
+	virtual size_t makeMove(const Board& b, Board::Player p);
+	//! rootPlayouts holds the visits of each root move, including the
+	//! ones carried over from a reused tree
+	virtual const SearchStats* lastStats() const;
+
+	//! Hands over to the exact Solver once at most emptyCells cells are
+	//! left, 0 turns it off
+	void setSolverThreshold(size_t emptyCells);
+
+private:
+	enum class Result : unsigned char { UNKNOWN, WIN, DRAW };
+
+	//score counts half points (2 per win, 1 per draw) and, like
+	//result, is from the point of view of the player who made move.
+	//Children are stored contiguously in the pool, firstChild is
+	//published by the release store to numChildren.
+	struct Node {
+		uint32_t firstChild;
+		std::atomic<uint32_t> visits;
+		std::atomic<uint32_t> score;
+		std::atomic<unsigned char> numChildren;
+		std::atomic_flag expanding;
+		unsigned char move;
+		Result result;
+
+		void init(unsigned char move, Result result);
+		void copyFrom(const Node& o);
+	};
+
+	size_t search(const Board& b, Board::Player p);
+	void newTree(const BitBoard& b, Board::Player p);
+	bool reuseTree(const BitBoard& b, Board::Player p);
+	void compact(uint32_t newRoot);
+	void expand(uint32_t node, BitBoard& b, Board::Player toMove);
+	uint32_t select(uint32_t node) const;
+	void iterate();
+	void work();
+
+	size_t _maxPlayouts;
+	size_t _maxNodes;
+	float _exploration;
+	size_t _threads;
+
+	std::unique_ptr<Node[]> _nodes;
+	std::unique_ptr<Node[]> _scratch;
+	std::atomic<uint32_t> _used;
+	std::atomic<long long> _remaining;
+	//playouts run by the workers, each adds its count once it's done
+	std::atomic<uint64_t> _playouts;
+
+	BitBoard _root;
+	Board::Player _rootToMove;
+	bool _hasTree;
+
+	SearchStats _stats;
+	std::unique_ptr<Solver> _solver;
+	size_t _solverThreshold;
+};
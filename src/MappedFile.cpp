@@ -0,0 +1,67 @@
+#include "MappedFile.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& path)
+	: _data(nullptr), _size(0), _buffer()
+{
+#ifndef _WIN32
+	int fd = open(path.c_str(), O_RDONLY);
+	if(fd < 0) {
+		throw std::runtime_error("Can't open " + path);
+	}
+
+	struct stat st;
+	if(fstat(fd, &st) != 0) {
+		close(fd);
+		throw std::runtime_error("Can't open " + path);
+	}
+
+	_size = st.st_size;
+	if(_size == 0) {
+		//mmap refuses empty mappings
+		close(fd);
+		return;
+	}
+
+	void* p = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(p == MAP_FAILED) {
+		throw std::runtime_error("Can't map " + path);
+	}
+	_data = static_cast<const unsigned char*>(p);
+#else
+	std::ifstream in(path, std::ios::binary);
+	if(!in) {
+		throw std::runtime_error("Can't open " + path);
+	}
+	_buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	_data = _buffer.data();
+	_size = _buffer.size();
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifndef _WIN32
+	if(_data) {
+		munmap(const_cast<unsigned char*>(_data), _size);
+	}
+#endif
+}
+
+const unsigned char* MappedFile::data() const {
+	return _data;
+}
+
+size_t MappedFile::size() const {
+	return _size;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+//! Read-only view of a whole file, memory mapped where the platform
+//! allows it and read into memory otherwise
+class MappedFile {
+public:
+	//! Throws std::runtime_error if path can't be opened
+	explicit MappedFile(const std::string& path);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	const unsigned char* data() const;
+	size_t size() const;
+
+private:
+	const unsigned char* _data;
+	size_t _size;
+
+	//only used where mmap isn't available
+	std::vector<unsigned char> _buffer;
+};
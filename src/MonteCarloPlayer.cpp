@@ -1,16 +1,75 @@
 #include "MonteCarloPlayer.hpp"
-#include "RandomPlayer.hpp"
+#include "BatchRollout.hpp"
 #include "Board.hpp"
-#include "Game.hpp"
+#include "BitBoard.hpp"
+#include "Confidence.hpp"
+#include "Random.hpp"
+#include "Rollout.hpp"
+#include "SearchStats.hpp"
+#include "Solver.hpp"
+#include "ThreadPool.hpp"
 
 #include <iostream>
 #include <vector>
 #include <memory>
 #include <stdexcept>
+#include <chrono>
+#include <algorithm>
 
-MonteCarloPlayer::MonteCarloPlayer(size_t maxGames) : _maxGames(maxGames) {}
+namespace {
+
+//! Part of the rollouts of one root move, run as a single pool task
+struct Chunk {
+	size_t move;
+	size_t games;
+	int score;
+};
+
+}
+
+//! Games per pool task, large enough to keep all the batch lanes busy
+static const size_t ROLLOUT_CHUNK = 512;
+
+MonteCarloPlayer::MonteCarloPlayer(size_t maxGames)
+	: _maxGames(maxGames), _solver(), _solverThreshold(SOLVER_THRESHOLD),
+	  _policy(RolloutPolicy::TACTICAL), _allocation(RootAllocation::HALVING), _earlyStop(EARLY_STOP_DELTA)
+{}
+
+void MonteCarloPlayer::setSolverThreshold(size_t emptyCells) {
+	_solverThreshold = emptyCells;
+}
+
+void MonteCarloPlayer::setRolloutPolicy(RolloutPolicy policy) {
+	_policy = policy;
+}
+
+void MonteCarloPlayer::setRootAllocation(RootAllocation allocation) {
+	_allocation = allocation;
+}
+
+void MonteCarloPlayer::setEarlyStop(double delta) {
+	if(delta < 0 || delta >= 1) {
+		throw std::invalid_argument("Early stop delta must be in [0, 1)");
+	}
+	_earlyStop = delta;
+}
+
+const SearchStats* MonteCarloPlayer::lastStats() const {
+	return &_stats;
+}
 
 size_t MonteCarloPlayer::makeMove(const Board& b, Board::Player p) {
+	auto start = std::chrono::steady_clock::now();
+	_stats.clear();
+
+	size_t move = search(b, p);
+
+	_stats.move = move;
+	_stats.totalSeconds = secondsSince(start);
+	return move;
+}
+
+size_t MonteCarloPlayer::search(const Board& b, Board::Player p) {
 	if(p == Board::Player::E) {
 		throw std::invalid_argument("Passed E as player");
 	}
@@ -21,104 +80,143 @@ size_t MonteCarloPlayer::makeMove(const Board& b, Board::Player p) {
 	if(moves.size() == 0) {
 		throw std::invalid_argument("No legal moves available");
 	}
-	std::vector<int> scores(moves.size());
-
-	size_t gamesPerMove = _maxGames / moves.size();
-	
-	
-	#pragma omp parallel for
-	for(size_t move = 0; move < moves.size(); move++) {
-		int score = 0;
-		
-		Board moved(b);
-		size_t t = moved.put(p, moves[move]);
-		if(causedWin(moved, moves[move], t)) {
-			scores[move] = gamesPerMove;
-			continue;
-		} else if(moved.isFull()) {
-			continue;
-		}
 
-		Game g(moved, std::unique_ptr<Player>(new RandomPlayer()), std::unique_ptr<Player>(new RandomPlayer()));
-
-		for(size_t i = 0; i < gamesPerMove; i++) {
-			g.board() = moved;
-			g.toMove() = o;
-			
-			Board::Player winner;
-			while((winner = g.step()) == Board::Player::NONE);
-
-			if(winner == p) {
-				score++;
-			} else if(winner == o) {
-				score--;
-			}
+	size_t solved;
+	if(solveEndgame(_solver, b, p, _solverThreshold, solved, &_stats)) {
+		return solved;
+	}
+	std::vector<Board> moved(moves.size(), b);
+	//moves still played out, and those that fill the board for a draw
+	std::vector<size_t> alive;
+	std::vector<size_t> drawn;
+	for(size_t i = 0; i < moves.size(); i++) {
+		size_t t = moved[i].put(p, moves[i]);
+		if(causedWin(moved[i], moves[i], t)) {
+			_stats.rootPlayouts.assign(b.width(), 0);
+			_stats.score = 1;
+			return moves[i];
 		}
 
-		scores[move] = score;
+		(moved[i].isFull() ? drawn : alive).push_back(i);
 	}
 
-	int best = -gamesPerMove - 1;
-	size_t bestMove = -1;
-	for(size_t i = 0; i < scores.size(); i++) {
-		if(scores[i] >= best) {
-			best = scores[i];
-			bestMove = moves[i];
+	std::vector<size_t> games(moves.size(), 0);
+	std::vector<int> scores(moves.size(), 0);
+	auto mean = [&](size_t i) {
+		return games[i] ? float(scores[i]) / games[i] : 0.0f;
+	};
+
+	_stats.rootPlayouts.assign(b.width(), 0);
+	auto rolloutStart = std::chrono::steady_clock::now();
+
+	//successive halving spends the same share of the games on every
+	//round and drops the worse half of the moves after each but the
+	//last, until two are left
+	size_t rounds = 1;
+	size_t budget = _maxGames / moves.size() * alive.size();
+	if(_allocation == RootAllocation::HALVING) {
+		budget = _maxGames;
+		while((size_t(1) << rounds) < alive.size()) {
+			rounds++;
 		}
 	}
 
-	return bestMove;
-}
-
-
-
-/*
-static double minimax(Board& b, size_t lvl, Board::Player p, Board::Player current) {
-	if(lvl == 0) {
-		return heuristic(b, p);
-	}
-	
-	vector<size_t> legalMoves;
-	for(size_t i = 0; i < b.width(); i++) {
-		if(!b.isColumnFull(i)) {
-			legalMoves.push_back(i);
+	//the moves still in, draws being exact. delta is shared out over
+	//every move and check.
+	size_t checks = 0;
+	auto estimates = [&]() {
+		const double delta = checkDelta(_earlyStop, moves.size(), ++checks);
+		std::vector<Estimate> e;
+		for(size_t i : alive) {
+			e.push_back({ mean(i), hoeffdingRadius(games[i], delta) });
+		}
+		for(size_t i = 0; i < drawn.size(); i++) {
+			e.push_back({ 0, 0 });
+		}
+		return e;
+	};
+
+	ThreadPool& pool = ThreadPool::shared();
+	const bool bits = BitBoard::fits(b.width(), b.height()) && b.winLength() == 4;
+	bool decided = false;
+	for(size_t round = 0; round < rounds && !alive.empty(); round++) {
+		const size_t roundGames = budget / (rounds - round);
+		budget -= roundGames;
+
+		//split the rollouts of every move into chunks, so threads that
+		//run out of work can take over part of another move's games.
+		//The moves take turns, so every wave of chunks moves them all on.
+		std::vector<Chunk> chunks;
+		for(size_t done = 0, added = 1; added; done += ROLLOUT_CHUNK) {
+			added = 0;
+			for(size_t j = 0; j < alive.size(); j++) {
+				const size_t share = roundGames / alive.size() + (j < roundGames % alive.size());
+				if(done < share) {
+					chunks.push_back({ alive[j], std::min(ROLLOUT_CHUNK, share - done), 0 });
+					added++;
+				}
+			}
 		}
-	}
 
-	if(current == p) {
-		double best = -1.0 / 0.0; // -inf
-		for(size_t move : legalMoves) {
-			size_t y = b.put(cur, move);
-			if(causedWin(move, y)) {
-				best = 1.0 / 0.0;
-				b.unput(move);
-				break;
+		//with an early stop, checked after every wave of a chunk per thread
+		const size_t wave = _earlyStop > 0 ? pool.size() : chunks.size();
+		for(size_t first = 0; first < chunks.size() && !decided; first += wave) {
+			const size_t n = std::min(wave, chunks.size() - first);
+			pool.parallelFor(n, [&](size_t c) {
+				static thread_local XorShift gen(randomSeed());
+				Chunk& chunk = chunks[first + c];
+				const Board& start = moved[chunk.move];
+
+				if(bits && _policy == RolloutPolicy::TACTICAL) {
+					chunk.score = tacticalRollouts(BitBoard(start), p, o, chunk.games, gen);
+				} else if(bits) {
+					RolloutCounts r = batchRollouts(BitBoard(start), p, o, chunk.games, gen);
+					chunk.score = int(r.wins) - int(r.losses);
+				} else {
+					chunk.score = boardRollouts(start, p, o, chunk.games, gen);
+				}
+			});
+
+			for(size_t c = first; c < first + n; c++) {
+				games[chunks[c].move] += chunks[c].games;
+				scores[chunks[c].move] += chunks[c].score;
+				_stats.rootPlayouts[moves[chunks[c].move]] += chunks[c].games;
 			}
 
-			best = std::max(best, minimax(b, lvl-1, p, current == Board::Player::P1 ? P2 : P1));
-			b.unput(move);
+			decided = _earlyStop > 0 && separated(estimates());
 		}
 
-		return best;
-	} else {
-		double worst = 1.0 / 0.0; // +inf
-		for(size_t move : legalMoves) {
-			size_t y = b.put(cur, move);
-			if(causedWin(move, y)) {
-				worst = -1.0 / 0.0;
-				b.unput(move);
-				break;
-			}
+		if(decided) {
+			break;
+		}
 
-			best = std::min(worst, minimax(b, lvl-1, p, current == Board::Player::P1 ? P2 : P1));
-			b.unput(move);
+		if(round + 1 < rounds) {
+			std::stable_sort(alive.begin(), alive.end(), [&](size_t x, size_t y) {
+				return mean(x) > mean(y);
+			});
+			alive.resize((alive.size() + 1) / 2);
+			std::sort(alive.begin(), alive.end());
 		}
+	}
 
-		return worst;
+	_stats.rolloutSeconds = secondsSince(rolloutStart);
+	for(uint64_t n : _stats.rootPlayouts) {
+		_stats.counters.playouts += n;
 	}
 
-	//inconceivable
-	return 0.0;
-}
-*/
+	std::vector<size_t> candidates(alive);
+	candidates.insert(candidates.end(), drawn.begin(), drawn.end());
+	std::sort(candidates.begin(), candidates.end());
+
+	float best = -2;
+	size_t bestMove = -1;
+	for(size_t i : candidates) {
+		if(mean(i) >= best) {
+			best = mean(i);
+			bestMove = moves[i];
+		}
+	}
+	_stats.score = best;
 
+	return bestMove;
+}
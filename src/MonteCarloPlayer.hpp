@@ -1,12 +1,55 @@
 #pragma once
 
 #include "Player.hpp"
+#include "Rollout.hpp"
+#include "SearchStats.hpp"
+#include "Solver.hpp"
+
+#include <memory>
+
+//! How MonteCarloPlayer spreads its games over the moves it can make
+enum class RootAllocation {
+	//! The same number for every move
+	UNIFORM,
+	//! Successive halving: rounds with an equal share of the games, each
+	//! but the last dropping the worse half of the moves, so clearly
+	//! losing moves get few games and the contenders most of them
+	HALVING
+};
 
 class MonteCarloPlayer : public Player {
 public:
 	MonteCarloPlayer(size_t maxGames);
 	virtual size_t makeMove(const Board& b, Board::Player p);
+	virtual const SearchStats* lastStats() const;
+
+	//! Hands over to the exact Solver once at most emptyCells cells are
+	//! left, 0 turns it off
+	void setSolverThreshold(size_t emptyCells);
+
+	//! TACTICAL, the default, only applies to connect four boards that
+	//! fit a BitBoard, others play random games
+	void setRolloutPolicy(RolloutPolicy policy);
+	//! HALVING by default
+	void setRootAllocation(RootAllocation allocation);
+
+	//! Stops the rollouts once the move with the best mean has the best
+	//! rollout value of the moves still in, with probability at least
+	//! 1 - delta: its Hoeffding interval lies above every other one's.
+	//! Checked between waves of rollout chunks, delta being shared out
+	//! over the moves and the checks (see checkDelta). 0 plays every
+	//! game. EARLY_STOP_DELTA by default.
+	void setEarlyStop(double delta);
 
 private:
+	size_t search(const Board& b, Board::Player p);
+
 	size_t _maxGames;
+	SearchStats _stats;
+
+	std::unique_ptr<Solver> _solver;
+	size_t _solverThreshold;
+	RolloutPolicy _policy;
+	RootAllocation _allocation;
+	double _earlyStop;
 };
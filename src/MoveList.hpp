@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+
+//! Fixed capacity list of columns that never allocates
+template<size_t N>
+class BasicMoveList {
+public:
+	BasicMoveList() : _size(0) {}
+
+	void push_back(size_t x) {
+		assert(_size < N);
+		_moves[_size++] = x;
+	}
+
+	//! Removes the first occurrence of x, keeping the order of the rest
+	void erase(size_t x) {
+		for(size_t i = 0; i < _size; i++) {
+			if(_moves[i] == x) {
+				for(size_t j = i + 1; j < _size; j++) {
+					_moves[j - 1] = _moves[j];
+				}
+				_size--;
+				return;
+			}
+		}
+	}
+
+	void clear() {
+		_size = 0;
+	}
+
+	size_t operator[](size_t i) const {
+		assert(i < _size);
+		return _moves[i];
+	}
+
+	size_t size() const {
+		return _size;
+	}
+
+	bool empty() const {
+		return _size == 0;
+	}
+
+	const unsigned char* begin() const {
+		return _moves;
+	}
+
+	const unsigned char* end() const {
+		return _moves + _size;
+	}
+
+private:
+	static_assert(N < 256, "Columns are stored in a byte");
+
+	unsigned char _moves[N];
+	unsigned char _size;
+};
+
+typedef BasicMoveList<64> MoveList;
+
+//! Columns of b that aren't full, from the middle outwards, appended to
+//! moves. first goes in front if it's one of them. Works with Board and
+//! FixedBoard, moves with MoveList or a std::vector for wider boards.
+template<class B, class L>
+void centerFirstMoves(const B& b, size_t first, L& moves) {
+	const size_t w = b.width();
+
+	if(first < w && !b.isColumnFull(first)) {
+		moves.push_back(first);
+	}
+
+	auto add = [&](size_t x) {
+		if(x != first && !b.isColumnFull(x)) {
+			moves.push_back(x);
+		}
+	};
+
+	//mid, mid - 1, mid + 1, mid - 2, ...
+	const size_t mid = w / 2;
+	add(mid);
+	for(size_t d = 1; d <= mid; d++) {
+		add(mid - d);
+		if(mid + d < w) {
+			add(mid + d);
+		}
+	}
+}
+
+//! Same in a new MoveList, b can't be wider than 64
+template<class B>
+MoveList centerFirstMoves(const B& b, size_t first = size_t(-1)) {
+	assert(b.width() <= 64);
+
+	MoveList moves;
+	centerFirstMoves(b, first, moves);
+	return moves;
+}
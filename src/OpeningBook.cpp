@@ -0,0 +1,133 @@
+#include "OpeningBook.hpp"
+#include "BitBoard.hpp"
+#include "Board.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static const char MAGIC[4] = { 'C', '4', 'B', 'K' };
+static const unsigned char VERSION = 1;
+
+static inline uint64_t readLE(const unsigned char* p) {
+	uint64_t v = 0;
+	for(int i = 7; i >= 0; i--) {
+		v = (v << 8) | p[i];
+	}
+	return v;
+}
+
+static inline void writeLE(std::ostream& out, uint64_t v) {
+	for(int i = 0; i < 8; i++) {
+		out.put(char(v & 0xFF));
+		v >>= 8;
+	}
+}
+
+OpeningBook::OpeningBook(const std::string& path)
+	: _file(path), _data(_file.data()), _count(0), _width(0), _height(0), _plies(0)
+{
+	size_t length = _file.size();
+	if(length < HEADER_SIZE || std::memcmp(_data, MAGIC, 4) != 0 || _data[4] != VERSION) {
+		throw std::runtime_error("Not an opening book: " + path);
+	}
+
+	_width  = _data[5];
+	_height = _data[6];
+	_plies  = _data[7];
+	_count  = readLE(_data + 8);
+
+	if(!BitBoard::fits(_width, _height) || (length - HEADER_SIZE) / ENTRY_SIZE < _count) {
+		throw std::runtime_error("Corrupt opening book " + path);
+	}
+}
+
+size_t OpeningBook::width() const {
+	return _width;
+}
+
+size_t OpeningBook::height() const {
+	return _height;
+}
+
+size_t OpeningBook::plies() const {
+	return _plies;
+}
+
+size_t OpeningBook::size() const {
+	return _count;
+}
+
+uint64_t OpeningBook::keyAt(size_t i) const {
+	return readLE(_data + HEADER_SIZE + i * ENTRY_SIZE);
+}
+
+uint64_t OpeningBook::key(const BitBoard& b, Board::Player p, bool& mirrored) {
+	uint64_t current = b.pieces(p);
+	uint64_t k  = current + b.mask();
+	uint64_t mk = b.mirror(current) + b.mirror(b.mask());
+
+	mirrored = mk < k;
+	return mirrored ? mk : k;
+}
+
+bool OpeningBook::lookup(const BitBoard& b, Board::Player p, size_t& move, int& score) const {
+	if(b.width() != _width || b.height() != _height || b.winLength() != 4) {
+		return false;
+	}
+
+	bool mirrored;
+	uint64_t k = key(b, p, mirrored);
+
+	size_t lo = 0;
+	size_t hi = _count;
+	while(lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if(keyAt(mid) < k) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	if(lo == _count || keyAt(lo) != k) {
+		return false;
+	}
+
+	const unsigned char* e = _data + HEADER_SIZE + lo * ENTRY_SIZE;
+	score = int8_t(e[8]);
+	move  = mirrored ? _width - 1 - e[9] : e[9];
+
+	return true;
+}
+
+void OpeningBook::write(const std::string& path, size_t width, size_t height, size_t plies, std::vector<Entry> entries) {
+	std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+		return a.key < b.key;
+	});
+
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	if(!out) {
+		throw std::runtime_error("Can't write opening book " + path);
+	}
+
+	out.write(MAGIC, 4);
+	out.put(char(VERSION));
+	out.put(char(width));
+	out.put(char(height));
+	out.put(char(std::min<size_t>(plies, 255)));
+	writeLE(out, entries.size());
+
+	for(const Entry& e : entries) {
+		writeLE(out, e.key);
+		out.put(char(e.score));
+		out.put(char(e.move));
+	}
+
+	if(!out) {
+		throw std::runtime_error("Failed writing opening book " + path);
+	}
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Board.hpp"
+#include "BitBoard.hpp"
+#include "MappedFile.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//! Read-only opening book backed by a memory mapped file.
+//!
+//! File layout, all integers little endian:
+//!   header  "C4BK", u8 version, u8 width, u8 height, u8 plies, u64 count
+//!   entries count * { u64 key, i8 score, u8 move }, sorted by key
+//!
+//! Keys are position + mask of the side to move (unique for a board
+//! that fits in a BitBoard), taken from whichever of the position and
+//! its mirror image gives the smaller key. The move is stored for that
+//! orientation. score is a Solver score, or UNKNOWN_SCORE if the
+//! position was only searched rather than solved.
+class OpeningBook {
+public:
+	static const int8_t UNKNOWN_SCORE = -128;
+
+	struct Entry {
+		uint64_t key;
+		int8_t score;
+		unsigned char move;
+	};
+
+	//! Throws std::runtime_error if path can't be opened or isn't a book
+	explicit OpeningBook(const std::string& path);
+
+	OpeningBook(const OpeningBook&) = delete;
+	OpeningBook& operator=(const OpeningBook&) = delete;
+
+	//! Looks up b with p to move, on a hit stores the move and score.
+	//! Books are for connect four, other win lengths always miss.
+	bool lookup(const BitBoard& b, Board::Player p, size_t& move, int& score) const;
+
+	size_t width() const;
+	size_t height() const;
+	size_t plies() const;
+	size_t size() const;
+
+	//! Canonical key of b with p to move, mirrored tells whether the
+	//! key was taken from the mirror image
+	static uint64_t key(const BitBoard& b, Board::Player p, bool& mirrored);
+
+	//! Sorts entries and writes them out as a book
+	static void write(const std::string& path, size_t width, size_t height, size_t plies, std::vector<Entry> entries);
+
+private:
+	static const size_t HEADER_SIZE = 16;
+	static const size_t ENTRY_SIZE = 10;
+
+	uint64_t keyAt(size_t i) const;
+
+	MappedFile _file;
+	const unsigned char* _data;
+	size_t _count;
+	size_t _width;
+	size_t _height;
+	size_t _plies;
+};
@@ -1,8 +1,14 @@
 #pragma once
 
 #include "Board.hpp"
+#include "SearchStats.hpp"
 
 class Player {
 public:
+	virtual ~Player() {}
 	virtual size_t makeMove(const Board& b, Board::Player p) = 0;
+
+	//! Statistics about the last makeMove, nullptr for players that
+	//! don't search
+	virtual const SearchStats* lastStats() const { return nullptr; }
 };
@@ -0,0 +1,106 @@
+#include "PlayerFactory.hpp"
+#include "BookPlayer.hpp"
+#include "HybridPlayer.hpp"
+#include "MCTSPlayer.hpp"
+#include "MonteCarloPlayer.hpp"
+#include "RandomPlayer.hpp"
+#include "TermPlayer.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static std::invalid_argument badSpec(const std::string& spec) {
+	return std::invalid_argument("Bad player spec: " + spec);
+}
+
+static size_t parseCount(const std::string& s, const std::string& spec) {
+	if(s.empty() || s.find_first_not_of("0123456789") != std::string::npos) {
+		throw badSpec(spec);
+	}
+
+	return std::strtoull(s.c_str(), nullptr, 10);
+}
+
+static std::vector<std::string> split(const std::string& s) {
+	std::vector<std::string> parts;
+	size_t start = 0;
+	for(size_t comma; (comma = s.find(',', start)) != std::string::npos; start = comma + 1) {
+		parts.push_back(s.substr(start, comma - start));
+	}
+	parts.push_back(s.substr(start));
+
+	return parts;
+}
+
+std::unique_ptr<Player> makePlayer(const std::string& spec) {
+	size_t colon = spec.find(':');
+	std::string name = spec.substr(0, colon);
+	std::string args = colon == std::string::npos ? "" : spec.substr(colon + 1);
+
+	if(name == "random" || name == "term") {
+		if(colon != std::string::npos) {
+			throw badSpec(spec);
+		}
+
+		return name == "random" ? std::unique_ptr<Player>(new RandomPlayer()) :
+		                          std::unique_ptr<Player>(new TermPlayer());
+	}
+
+	if(name == "book") {
+		size_t comma = args.find(',');
+		if(comma == 0 || comma == std::string::npos) {
+			throw badSpec(spec);
+		}
+
+		return std::unique_ptr<Player>(new BookPlayer(args.substr(0, comma), makePlayer(args.substr(comma + 1))));
+	}
+
+	std::vector<std::string> a = split(args);
+
+	if(name == "hybrid" && a.size() > 1 && a.back() == "eval") {
+		a.pop_back();
+
+		std::string plain = "hybrid:" + a[0];
+		for(size_t i = 1; i < a.size(); i++) {
+			plain += "," + a[i];
+		}
+
+		std::unique_ptr<Player> p = makePlayer(plain);
+		static_cast<HybridPlayer&>(*p).setEvaluation(true);
+		return p;
+	}
+
+	if(name == "mc") {
+		std::unique_ptr<MonteCarloPlayer> p(new MonteCarloPlayer(parseCount(a[0], spec)));
+		for(size_t i = 1; i < a.size(); i++) {
+			if(a[i] == "random" || a[i] == "tactical") {
+				p->setRolloutPolicy(a[i] == "random" ? RolloutPolicy::RANDOM : RolloutPolicy::TACTICAL);
+			} else if(a[i] == "uniform") {
+				p->setRootAllocation(RootAllocation::UNIFORM);
+			} else {
+				throw badSpec(spec);
+			}
+		}
+		return p;
+	}
+
+	if(name == "hybrid" && a.size() == 2) {
+		return std::unique_ptr<Player>(new HybridPlayer(parseCount(a[0], spec), parseCount(a[1], spec)));
+	}
+
+	if(name == "hybrid" && a.size() == 1 && a[0].size() > 2 && a[0].compare(a[0].size() - 2, 2, "ms") == 0) {
+		size_t ms = parseCount(a[0].substr(0, a[0].size() - 2), spec);
+		return std::unique_ptr<Player>(new HybridPlayer(std::chrono::milliseconds(ms)));
+	}
+
+	if(name == "mcts" && (a.size() == 1 || a.size() == 2)) {
+		size_t threads = a.size() == 2 ? parseCount(a[1], spec) : 1;
+		return std::unique_ptr<Player>(new MCTSPlayer(parseCount(a[0], spec), 1 << 20, 1.41f, threads));
+	}
+
+	throw badSpec(spec);
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Player.hpp"
+
+#include <memory>
+#include <string>
+
+//! Builds a player from a spec of the form name[:arg,arg...]
+//!   random
+//!   term
+//!   mc:GAMES[,random|,tactical][,uniform]
+//!                         random plays uniformly random rollouts rather
+//!                         than the default TacticalRollout ones (tactical),
+//!                         uniform gives every move the same games
+//!                         instead of halving
+//!   hybrid:GAMES,DEPTH    or hybrid:MSms for a time budget, either
+//!                         followed by ,eval to score leaves statically
+//!   mcts:PLAYOUTS[,THREADS]
+//!   book:PATH,SPEC        SPEC is the fallback player
+//! Throws std::invalid_argument on a malformed spec.
+std::unique_ptr<Player> makePlayer(const std::string& spec);
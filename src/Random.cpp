@@ -0,0 +1,16 @@
+#include "Random.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+uint64_t randomSeed() {
+	//threads started in the same clock tick still get different seeds
+	static std::atomic<uint64_t> counter(0);
+
+	uint64_t t = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+	uint64_t id = std::hash<std::thread::id>()(std::this_thread::get_id());
+
+	return t ^ (id << 32) ^ (counter.fetch_add(1) * 0x9E3779B97F4A7C15ull);
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+//! xorshift64* generator. Much cheaper than std::default_random_engine
+//! plus a distribution, good enough for random playouts. Meets the
+//! UniformRandomBitGenerator requirements so it also works with the
+//! standard distributions.
+class XorShift {
+public:
+	typedef uint64_t result_type;
+
+	explicit XorShift(uint64_t seed = 0x9E3779B97F4A7C15ull);
+
+	void seed(uint64_t s);
+
+	result_type operator()();
+
+	//! Uniform in [0, n), n must fit in 32 bits
+	uint32_t below(uint32_t n);
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+private:
+	uint64_t _state;
+};
+
+//! Seed that differs between threads and runs
+uint64_t randomSeed();
+
+
+inline XorShift::XorShift(uint64_t s) {
+	seed(s);
+}
+
+inline void XorShift::seed(uint64_t s) {
+	//splitmix64 step, spreads out similar seeds and never gives 0 for
+	//the seeds anyone uses in practice
+	uint64_t z = s + 0x9E3779B97F4A7C15ull;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	z ^= z >> 31;
+
+	_state = z ? z : 1;
+}
+
+inline XorShift::result_type XorShift::operator()() {
+	_state ^= _state >> 12;
+	_state ^= _state << 25;
+	_state ^= _state >> 27;
+	return _state * 0x2545F4914F6CDD1Dull;
+}
+
+inline uint32_t XorShift::below(uint32_t n) {
+	//multiply by the high word instead of taking a modulo
+	return uint32_t(((*this)() >> 32) * n >> 32);
+}
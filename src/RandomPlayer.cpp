@@ -1,8 +1,7 @@
 #include "RandomPlayer.hpp"
 #include "Board.hpp"
+#include "Random.hpp"
 
-#include <random>
-#include <chrono>
 #include <vector>
 #include <stdexcept>
 
@@ -16,8 +15,7 @@ size_t RandomPlayer::makeMove(const Board& b, Board::Player p) {
 		throw invalid_argument("No possible legal moves");
 	}
 
-	static thread_local default_random_engine g(chrono::high_resolution_clock::now().time_since_epoch().count());
-	uniform_int_distribution<int> d(0, moves.size() - 1);
+	static thread_local XorShift g(randomSeed());
 
-	return moves[d(g)];
+	return moves[g.below(moves.size())];
 }
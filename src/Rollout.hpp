@@ -0,0 +1,235 @@
+#pragma once
+
+#include "Board.hpp"
+#include "BitBoard.hpp"
+#include "Bits.hpp"
+#include "FixedBoard.hpp"
+#include "WideBitBoard.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <utility>
+
+//! Plays uniformly random moves on b starting with toMove until the game
+//! ends, straight on the board without going through Game or Player.
+//! Returns the winner, or E on a draw. b must not be over already.
+//! Works with Board, FixedBoard and BasicWideBitBoard, Rng needs a below(n) like XorShift.
+template<class B, class Rng>
+Board::Player rollout(B& b, Board::Player toMove, Rng& g);
+
+//! Same for a BitBoard, picks cells straight out of legalMask
+template<class Rng>
+Board::Player rollout(BitBoard& b, Board::Player toMove, Rng& g);
+
+//! Plays games rollouts from start with toMove to move. Returns wins
+//! minus losses from the point of view of p.
+template<class B, class Rng>
+int rollouts(const B& start, Board::Player p, Board::Player toMove, size_t games, Rng& g);
+
+//! How rollouts pick their moves
+enum class RolloutPolicy {
+	//! Uniformly at random
+	RANDOM,
+	//! See TacticalRollout
+	TACTICAL
+};
+
+//! Rollout policy for connect four on a BitBoard. Takes an immediate win
+//! if there is one, else blocks the opponent's, else picks a random
+//! move that doesn't let the opponent win right on top of it, central
+//! columns being up to three times as likely as the edges. Each side's
+//! threats are bitboard masks kept from its own last move, so a move
+//! costs one BitBoard::threats on top of a random one and never needs a
+//! separate check for four.
+class TacticalRollout {
+public:
+	explicit TacticalRollout(const BitBoard& b);
+
+	//! Same contract as rollout
+	template<class Rng>
+	Board::Player operator()(BitBoard& b, Board::Player toMove, Rng& g) const;
+
+private:
+	//cells of the central columns, counted once more each
+	uint64_t _inner;
+	uint64_t _middle;
+};
+
+//! rollouts played with TacticalRollout. start must have four to win.
+template<class Rng>
+int tacticalRollouts(const BitBoard& start, Board::Player p, Board::Player toMove, size_t games, Rng& g);
+
+//! Same as rollouts on a Board, but played on a BasicWideBitBoard when
+//! start fits one, which also beats FixedBoard on the sizes that have one
+template<class Rng>
+int boardRollouts(const Board& start, Board::Player p, Board::Player toMove, size_t games, Rng& g);
+
+
+template<class B, class Rng>
+Board::Player rollout(B& b, Board::Player toMove, Rng& g) {
+	while(true) {
+		const auto& moves = b.legalMoves();
+		if(moves.empty()) {
+			return Board::Player::E;
+		}
+
+		b.put(toMove, moves[g.below(moves.size())]);
+
+		//put keeps the winner up to date
+		if(b.winner() != Board::Player::E) {
+			return toMove;
+		}
+
+		toMove = toMove == Board::Player::P2 ? Board::Player::P1 :
+		                                       Board::Player::P2;
+	}
+}
+
+template<class Rng>
+Board::Player rollout(BitBoard& b, Board::Player toMove, Rng& g) {
+	const size_t k = b.winLength();
+
+	while(true) {
+		uint64_t legal = b.legalMask();
+		if(!legal) {
+			return Board::Player::E;
+		}
+
+		b.putCell(toMove, nthBit(legal, g.below(popcount64(legal))));
+
+		const uint64_t own = b.pieces(toMove);
+		if(k == 4 ? BitBoard::hasFour(own, b.height()) : BitBoard::hasRun(own, b.height(), k)) {
+			return toMove;
+		}
+
+		toMove = toMove == Board::Player::P2 ? Board::Player::P1 :
+		                                       Board::Player::P2;
+	}
+}
+
+template<class B, class Rng>
+int rollouts(const B& start, Board::Player p, Board::Player toMove, size_t games, Rng& g) {
+	int score = 0;
+
+	//assigning reuses sim's storage, so this doesn't allocate
+	B sim(start);
+	for(size_t i = 0; i < games; i++) {
+		sim = start;
+		Board::Player winner = rollout(sim, toMove, g);
+
+		if(winner == p) {
+			score++;
+		} else if(winner != Board::Player::E) {
+			score--;
+		}
+	}
+
+	return score;
+}
+
+inline TacticalRollout::TacticalRollout(const BitBoard& b)
+	: _inner(0), _middle(0)
+{
+	assert(b.winLength() == 4);
+
+	const size_t w = b.width();
+	const size_t stride = b.height() + 1;
+	for(size_t x = 0; x < w; x++) {
+		const uint64_t col = b.playable() & (((uint64_t(1) << stride) - 1) << (x * stride));
+
+		//twice the distance from the centre, so even widths work too
+		const size_t d = 2 * x > w - 1 ? 2 * x - (w - 1) : (w - 1) - 2 * x;
+		_inner  |= d <= w / 2 ? col : 0;
+		_middle |= d <= 1 ? col : 0;
+	}
+}
+
+template<class Rng>
+Board::Player TacticalRollout::operator()(BitBoard& b, Board::Player toMove, Rng& g) const {
+	Board::Player other = toMove == Board::Player::P2 ? Board::Player::P1 :
+	                                                    Board::Player::P2;
+	//a player's threats only change when it moves, the other's pieces
+	//just fill some of them, which legalMask takes care of
+	uint64_t own = b.threats(toMove);
+	uint64_t theirs = b.threats(other);
+
+	while(true) {
+		const uint64_t legal = b.legalMask();
+		if(!legal) {
+			return Board::Player::E;
+		}
+
+		if(own & legal) {
+			b.putCell(toMove, own & legal & -(own & legal));
+			return toMove;
+		}
+
+		uint64_t cell = theirs & legal;
+		if(cell) {
+			//with two to block the game is lost either way
+			cell &= -cell;
+		} else {
+			//playing right under a threat lets the opponent take it
+			uint64_t safe = legal & ~(theirs >> 1);
+			safe = safe ? safe : legal;
+
+			const unsigned all = popcount64(safe);
+			const unsigned inner = popcount64(safe & _inner);
+			unsigned r = g.below(all + inner + popcount64(safe & _middle));
+
+			cell = r < all           ? nthBit(safe, r) :
+			       r < all + inner   ? nthBit(safe & _inner, r - all) :
+			                           nthBit(safe & _middle, r - all - inner);
+		}
+		b.putCell(toMove, cell);
+
+		//anything that would have won was taken above
+		own = theirs;
+		theirs = b.threats(toMove);
+		std::swap(toMove, other);
+	}
+}
+
+template<class Rng>
+int tacticalRollouts(const BitBoard& start, Board::Player p, Board::Player toMove, size_t games, Rng& g) {
+	const TacticalRollout policy(start);
+	int score = 0;
+
+	for(size_t i = 0; i < games; i++) {
+		BitBoard sim(start);
+		Board::Player winner = policy(sim, toMove, g);
+
+		if(winner == p) {
+			score++;
+		} else if(winner != Board::Player::E) {
+			score--;
+		}
+	}
+
+	return score;
+}
+
+//! Runs rollouts on whichever board withWideBitBoard hands it
+template<class Rng>
+struct RolloutsOn {
+	Board::Player p;
+	Board::Player toMove;
+	size_t games;
+	Rng& g;
+	int score;
+
+	template<class B>
+	void operator()(const B& b) {
+		score = rollouts(b, p, toMove, games, g);
+	}
+};
+
+template<class Rng>
+int boardRollouts(const Board& start, Board::Player p, Board::Player toMove, size_t games, Rng& g) {
+	RolloutsOn<Rng> r = { p, toMove, games, g, 0 };
+	if(withWideBitBoard(start, r)) {
+		return r.score;
+	}
+
+	return rollouts(start, p, toMove, games, g);
+}
@@ -0,0 +1,66 @@
+#include "SearchStats.hpp"
+
+#include <sstream>
+#include <string>
+
+SearchCounters::SearchCounters()
+	: nodes(0), cutoffs(0), ttProbes(0), ttHits(0), playouts(0)
+{}
+
+SearchCounters& SearchCounters::operator+=(const SearchCounters& o) {
+	nodes    += o.nodes;
+	cutoffs  += o.cutoffs;
+	ttProbes += o.ttProbes;
+	ttHits   += o.ttHits;
+	playouts += o.playouts;
+
+	return *this;
+}
+
+SearchStats::SearchStats() {
+	clear();
+}
+
+void SearchStats::clear() {
+	counters = SearchCounters();
+	solverNodes = 0;
+	depth = 0;
+	solved = false;
+	book = false;
+	rootPlayouts.clear();
+	solverSeconds = 0;
+	searchSeconds = 0;
+	rolloutSeconds = 0;
+	totalSeconds = 0;
+	move = 0;
+	score = 0;
+}
+
+std::string SearchStats::toJson() const {
+	std::ostringstream s;
+
+	s << "{\"move\":" << move
+	  << ",\"score\":" << score
+	  << ",\"nodes\":" << counters.nodes
+	  << ",\"cutoffs\":" << counters.cutoffs
+	  << ",\"tt_probes\":" << counters.ttProbes
+	  << ",\"tt_hits\":" << counters.ttHits
+	  << ",\"playouts\":" << counters.playouts
+	  << ",\"solver_nodes\":" << solverNodes
+	  << ",\"depth\":" << depth
+	  << ",\"solved\":" << (solved ? "true" : "false")
+	  << ",\"book\":" << (book ? "true" : "false")
+	  << ",\"root_playouts\":[";
+
+	for(size_t i = 0; i < rootPlayouts.size(); i++) {
+		s << (i ? "," : "") << rootPlayouts[i];
+	}
+
+	s << "],\"solver_ms\":" << solverSeconds * 1000
+	  << ",\"search_ms\":" << searchSeconds * 1000
+	  << ",\"rollout_ms\":" << rolloutSeconds * 1000
+	  << ",\"total_ms\":" << totalSeconds * 1000
+	  << "}";
+
+	return s.str();
+}
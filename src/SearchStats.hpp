@@ -0,0 +1,56 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//! Counters a search bumps in its inner loops. Every thread or task
+//! keeps its own and adds it to the shared total once it's done, so the
+//! hot paths never write to shared memory.
+struct SearchCounters {
+	//minimax positions visited or MCTS nodes added
+	uint64_t nodes;
+	//alpha-beta cutoffs
+	uint64_t cutoffs;
+	uint64_t ttProbes;
+	uint64_t ttHits;
+	uint64_t playouts;
+
+	SearchCounters();
+	SearchCounters& operator+=(const SearchCounters& o);
+};
+
+//! What a player's last makeMove did. Times are wall clock.
+struct SearchStats {
+	SearchCounters counters;
+	uint64_t solverNodes;
+	//deepest minimax depth searched to the end
+	unsigned depth;
+	//answered by the Solver
+	bool solved;
+	//answered from an opening book
+	bool book;
+	//playouts per root move, indexed by column
+	std::vector<uint64_t> rootPlayouts;
+
+	double solverSeconds;
+	double searchSeconds;
+	double rolloutSeconds;
+	double totalSeconds;
+	size_t move;
+	//value of move for the player making it, from -1 for a sure loss
+	//to 1 for a sure win
+	float score;
+
+	SearchStats();
+	void clear();
+
+	//! A single line JSON object
+	std::string toJson() const;
+};
+
+//! Seconds since start
+inline double secondsSince(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
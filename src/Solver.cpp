@@ -0,0 +1,307 @@
+#include "Solver.hpp"
+#include "BitBoard.hpp"
+#include "Bits.hpp"
+#include "Board.hpp"
+#include "SearchStats.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+
+Solver::Solver(size_t ttMegabytes)
+	: _tt(ttMegabytes), _nodes(0), _maxNodes(0), _aborted(false),
+	  _width(0), _height(0), _bottom(0), _playable(0)
+{}
+
+uint64_t Solver::nodes() const {
+	return _nodes;
+}
+
+void Solver::setup(size_t width, size_t height) {
+	if(width == _width && height == _height) {
+		return;
+	}
+
+	//keys are only unique for a given board size
+	_tt.clear();
+	_width = width;
+	_height = height;
+	_bottom = 0;
+	_playable = 0;
+
+	for(size_t x = 0; x < width; x++) {
+		_bottom   |= uint64_t(1) << (x * (height + 1));
+		_playable |= ((uint64_t(1) << height) - 1) << (x * (height + 1));
+	}
+
+	for(size_t i = 0; i < width; i++) {
+		//middle column, then alternating left and right of it
+		_order[i] = int(width / 2) + (1 - 2 * int(i % 2)) * int(i + 1) / 2;
+	}
+}
+
+uint64_t Solver::winningCells(uint64_t p, uint64_t mask) const {
+	const unsigned s = _height + 1;
+
+	//vertical
+	uint64_t r = (p << 1) & (p << 2) & (p << 3);
+
+	//horizontal and both diagonals, the empty cell can be at any
+	//of the four positions in the line
+	const unsigned dirs[3] = { s, s - 1, s + 1 };
+	for(unsigned d : dirs) {
+		uint64_t t = (p << d) & (p << 2 * d);
+		r |= t & (p << 3 * d);
+		r |= t & (p >> d);
+		t = (p >> d) & (p >> 2 * d);
+		r |= t & (p << d);
+		r |= t & (p >> 3 * d);
+	}
+
+	return r & (_playable ^ mask);
+}
+
+uint64_t Solver::possible(uint64_t mask) const {
+	return (mask + _bottom) & _playable;
+}
+
+bool Solver::canWinNext(const Position& pos) const {
+	return (winningCells(pos.current, pos.mask) & possible(pos.mask)) != 0;
+}
+
+uint64_t Solver::nonLosingMoves(const Position& pos) const {
+	uint64_t moves = possible(pos.mask);
+	uint64_t threats = winningCells(pos.current ^ pos.mask, pos.mask);
+	uint64_t forced = moves & threats;
+
+	if(forced) {
+		if(forced & (forced - 1)) {
+			//two threats to block at once
+			return 0;
+		}
+		moves = forced;
+	}
+
+	//never play right below a cell the opponent wins on
+	return moves & ~(threats >> 1);
+}
+
+uint64_t Solver::column(size_t x) const {
+	return ((uint64_t(1) << _height) - 1) << (x * (_height + 1));
+}
+
+int Solver::negamax(const Position& pos, int alpha, int beta) {
+	assert(alpha < beta);
+	assert(!canWinNext(pos));
+
+	if(++_nodes == _maxNodes) {
+		_aborted = true;
+	}
+	if(_aborted) {
+		return 0;
+	}
+
+	const int cells = _width * _height;
+
+	uint64_t next = nonLosingMoves(pos);
+	if(!next) {
+		return -(cells - pos.moves) / 2;
+	}
+
+	if(pos.moves >= cells - 2) {
+		return 0;
+	}
+
+	//can't lose before the opponent's next move nor win before our next one
+	int lo = -(cells - 2 - pos.moves) / 2;
+	int hi =  (cells - 1 - pos.moves) / 2;
+
+	uint64_t key = pos.current + pos.mask;
+	TranspositionTable::Entry e;
+	if(_tt.probe(key, e)) {
+		if(e.bound == TranspositionTable::Bound::UPPER) {
+			hi = std::min(hi, int(e.value));
+		} else if(e.bound == TranspositionTable::Bound::LOWER) {
+			lo = std::max(lo, int(e.value));
+		}
+	}
+
+	if(alpha < lo) {
+		alpha = lo;
+		if(alpha >= beta) {
+			return alpha;
+		}
+	}
+	if(hi < beta) {
+		beta = hi;
+		if(alpha >= beta) {
+			return beta;
+		}
+	}
+
+	//insertion sort by the number of threats each move creates, ties
+	//keep the center first order
+	uint64_t moves[64];
+	int scores[64];
+	size_t n = 0;
+	for(size_t i = 0; i < _width; i++) {
+		uint64_t move = next & column(_order[i]);
+		if(!move) {
+			continue;
+		}
+
+		int s = popcount64(winningCells(pos.current | move, pos.mask));
+
+		size_t j = n++;
+		for(; j > 0 && scores[j - 1] < s; j--) {
+			moves[j] = moves[j - 1];
+			scores[j] = scores[j - 1];
+		}
+		moves[j] = move;
+		scores[j] = s;
+	}
+
+	for(size_t i = 0; i < n; i++) {
+		//the opponent is to move in the child
+		Position child = { pos.current ^ pos.mask, pos.mask | moves[i], pos.moves + 1 };
+
+		int s = -negamax(child, -beta, -alpha);
+		if(_aborted) {
+			//nothing below here can be trusted
+			return 0;
+		}
+		if(s >= beta) {
+			_tt.store(key, { float(s), 0, TranspositionTable::Bound::LOWER, 0 });
+			return s;
+		}
+		if(s > alpha) {
+			alpha = s;
+		}
+	}
+
+	_tt.store(key, { float(alpha), 0, TranspositionTable::Bound::UPPER, 0 });
+	return alpha;
+}
+
+Solver::Result Solver::solve(const BitBoard& b, Board::Player p) {
+	Result r;
+	trySolve(b, p, 0, r);
+	return r;
+}
+
+bool Solver::trySolve(const BitBoard& b, Board::Player p, uint64_t maxNodes, Result& result) {
+	assert(p != Board::Player::E);
+	assert(!b.isGameOver());
+	assert(b.winLength() == 4);
+
+	setup(b.width(), b.height());
+	_nodes = 0;
+	_maxNodes = maxNodes;
+	_aborted = false;
+
+	const int cells = _width * _height;
+	Position pos = { b.pieces(p), b.mask(), int(popcount64(b.mask())) };
+
+	uint64_t wins = winningCells(pos.current, pos.mask) & possible(pos.mask);
+	if(wins) {
+		result = { (cells + 1 - pos.moves) / 2, size_t(ctz64(wins) / (_height + 1)) };
+		return true;
+	}
+
+	//narrow the score down with null windows, probing closer to 0 first
+	int lo = -(cells - pos.moves) / 2;
+	int hi = (cells + 1 - pos.moves) / 2;
+	while(lo < hi) {
+		int med = lo + (hi - lo) / 2;
+		if(med <= 0 && lo / 2 < med) {
+			med = lo / 2;
+		} else if(med >= 0 && hi / 2 > med) {
+			med = hi / 2;
+		}
+
+		int r = negamax(pos, med, med + 1);
+		if(_aborted) {
+			return false;
+		}
+		if(r <= med) {
+			hi = r;
+		} else {
+			lo = r;
+		}
+	}
+	int best = lo;
+
+	//find a move that reaches the score
+	size_t fallback = _width;
+	for(size_t i = 0; i < _width; i++) {
+		size_t x = _order[i];
+		uint64_t move = possible(pos.mask) & column(x);
+		if(!move) {
+			continue;
+		}
+		if(fallback == _width) {
+			fallback = x;
+		}
+
+		Position child = { pos.current ^ pos.mask, pos.mask | move, pos.moves + 1 };
+		if(child.moves == cells) {
+			if(best <= 0) {
+				result = { best, x };
+				return true;
+			}
+			continue;
+		}
+
+		int s;
+		if(canWinNext(child)) {
+			s = -(cells + 1 - child.moves) / 2;
+		} else {
+			s = -negamax(child, -best, -best + 1);
+		}
+
+		if(_aborted) {
+			return false;
+		}
+		if(s >= best) {
+			result = { best, x };
+			return true;
+		}
+	}
+
+	result = { best, fallback };
+	return true;
+}
+
+size_t emptyCells(const Board& b) {
+	size_t empty = 0;
+	for(size_t x = 0; x < b.width(); x++) {
+		for(size_t y = b.height(); y > 0 && b(x, y - 1) == Board::Player::E; y--) {
+			empty++;
+		}
+	}
+
+	return empty;
+}
+
+bool solveEndgame(std::unique_ptr<Solver>& s, const Board& b, Board::Player p, size_t threshold, size_t& move, SearchStats* stats) {
+	if(!BitBoard::fits(b.width(), b.height()) || b.winLength() != 4 || b.isGameOver() || emptyCells(b) > threshold) {
+		return false;
+	}
+
+	if(!s) {
+		s.reset(new Solver());
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	Solver::Result r = s->solve(BitBoard(b), p);
+	move = r.move;
+
+	if(stats) {
+		stats->score = r.score > 0 ? 1 : r.score < 0 ? -1 : 0;
+		stats->solved = true;
+		stats->solverNodes = s->nodes();
+		stats->solverSeconds = secondsSince(start);
+	}
+
+	return true;
+}
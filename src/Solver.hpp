@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Board.hpp"
+#include "BitBoard.hpp"
+#include "SearchStats.hpp"
+#include "TranspositionTable.hpp"
+
+#include <cstdint>
+#include <memory>
+
+//! Exact negamax solver for connect four positions that fit in a
+//! BitBoard.
+//! Alpha-beta with null window probing of the score, a transposition
+//! table, center first move ordering and pruning of moves that lose
+//! right away.
+//!
+//! Scores are from the point of view of the player to move: 0 is a
+//! draw, a positive score a win and a negative one a loss. A win with
+//! n pieces on the board before the winning piece goes in is worth
+//! (width * height + 1 - n) / 2, so faster wins score higher.
+class Solver {
+public:
+	struct Result {
+		int score;
+		size_t move;
+	};
+
+	explicit Solver(size_t ttMegabytes = 8);
+
+	//! Solves b with p to move. b must not be won or full.
+	Result solve(const BitBoard& b, Board::Player p);
+
+	//! Like solve, but gives up and returns false after visiting
+	//! maxNodes positions
+	bool trySolve(const BitBoard& b, Board::Player p, uint64_t maxNodes, Result& r);
+
+	//! Positions visited by the last solve
+	uint64_t nodes() const;
+
+private:
+	struct Position {
+		uint64_t current;
+		uint64_t mask;
+		int moves;
+	};
+
+	void setup(size_t width, size_t height);
+	uint64_t column(size_t x) const;
+	int negamax(const Position& pos, int alpha, int beta);
+
+	uint64_t winningCells(uint64_t pieces, uint64_t mask) const;
+	uint64_t possible(uint64_t mask) const;
+	uint64_t nonLosingMoves(const Position& pos) const;
+	bool canWinNext(const Position& pos) const;
+
+	TranspositionTable _tt;
+	uint64_t _nodes;
+	uint64_t _maxNodes;
+	bool _aborted;
+
+	size_t _width;
+	size_t _height;
+	uint64_t _bottom;
+	uint64_t _playable;
+	//columns, center first
+	unsigned char _order[64];
+};
+
+//! Number of empty cells on b
+size_t emptyCells(const Board& b);
+
+//! Default number of empty cells below which players switch to the solver
+const size_t SOLVER_THRESHOLD = 20;
+
+//! Lets a player hand over to the solver in the endgame. If b fits in a
+//! BitBoard, is played to four in a row and has at most threshold empty cells, stores the best move
+//! for p in move and returns true. The solver is created on first use.
+//! Records what the solver did in stats if given.
+bool solveEndgame(std::unique_ptr<Solver>& s, const Board& b, Board::Player p, size_t threshold, size_t& move, SearchStats* stats = nullptr);
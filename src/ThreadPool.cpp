@@ -0,0 +1,148 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+ThreadPool::ThreadPool(size_t threads)
+	: _threads(), _queues(), _size(threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency())),
+	  _generation(0), _stop(false), _error(), _job(nullptr), _pending(0)
+{
+	_busy.clear();
+	_queues.reset(new Queue[_size]);
+
+	for(size_t i = 1; i < _size; i++) {
+		_threads.emplace_back(&ThreadPool::worker, this, i);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(_m);
+		_stop = true;
+	}
+	_wake.notify_all();
+
+	for(auto& t : _threads) {
+		t.join();
+	}
+}
+
+size_t ThreadPool::size() const {
+	return _size;
+}
+
+ThreadPool& ThreadPool::shared() {
+	static ThreadPool pool;
+	return pool;
+}
+
+void ThreadPool::parallelFor(size_t n, const std::function<void(size_t)>& f) {
+	if(n == 0) {
+		return;
+	}
+
+	if(_size == 1 || n == 1 || _busy.test_and_set(std::memory_order_acquire)) {
+		for(size_t i = 0; i < n; i++) {
+			f(i);
+		}
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_m);
+		_job.store(&f, std::memory_order_release);
+		_error = nullptr;
+		_pending = n;
+
+		//contiguous blocks, so neighbouring tasks stay on one thread
+		//unless someone steals them
+		for(size_t s = 0; s < _size; s++) {
+			std::lock_guard<std::mutex> q(_queues[s].m);
+			for(size_t i = s * n / _size; i < (s + 1) * n / _size; i++) {
+				_queues[s].tasks.push_back(i);
+			}
+		}
+
+		_generation++;
+	}
+	_wake.notify_all();
+
+	drain(0);
+
+	std::exception_ptr error;
+	{
+		std::unique_lock<std::mutex> lock(_m);
+		_done.wait(lock, [this]() { return _pending.load() == 0; });
+		_job.store(nullptr, std::memory_order_relaxed);
+		error = _error;
+	}
+
+	_busy.clear(std::memory_order_release);
+
+	if(error) {
+		std::rethrow_exception(error);
+	}
+}
+
+void ThreadPool::worker(size_t slot) {
+	unsigned long seen = 0;
+
+	std::unique_lock<std::mutex> lock(_m);
+	while(true) {
+		_wake.wait(lock, [&]() { return _stop || _generation != seen; });
+		if(_stop) {
+			return;
+		}
+		seen = _generation;
+
+		lock.unlock();
+		drain(slot);
+		lock.lock();
+	}
+}
+
+bool ThreadPool::pop(size_t slot, size_t& task) {
+	{
+		std::lock_guard<std::mutex> lock(_queues[slot].m);
+		if(!_queues[slot].tasks.empty()) {
+			task = _queues[slot].tasks.back();
+			_queues[slot].tasks.pop_back();
+			return true;
+		}
+	}
+
+	for(size_t i = 1; i < _size; i++) {
+		Queue& q = _queues[(slot + i) % _size];
+
+		std::lock_guard<std::mutex> lock(q.m);
+		if(!q.tasks.empty()) {
+			task = q.tasks.front();
+			q.tasks.pop_front();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void ThreadPool::drain(size_t slot) {
+	size_t task;
+	while(pop(slot, task)) {
+		try {
+			(*_job.load(std::memory_order_acquire))(task);
+		} catch(...) {
+			std::lock_guard<std::mutex> lock(_m);
+			if(!_error) {
+				_error = std::current_exception();
+			}
+		}
+
+		if(_pending.fetch_sub(1) == 1) {
+			std::lock_guard<std::mutex> lock(_m);
+			_done.notify_all();
+		}
+	}
+}
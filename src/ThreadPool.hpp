@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//! Persistent pool of worker threads with work stealing. parallelFor
+//! deals a range of tasks out to one queue per thread, each thread
+//! works through its own queue from the back and, once that's empty,
+//! steals from the front of the others. Threads are started once and
+//! sleep between calls.
+class ThreadPool {
+public:
+	//! threads == 0 uses every hardware thread. The thread calling
+	//! parallelFor works too, so threads - 1 workers are started.
+	explicit ThreadPool(size_t threads = 0);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	//! Threads that take part in a parallelFor, the caller included
+	size_t size() const;
+
+	//! Runs f(i) for every i in [0, n) and returns once all of them
+	//! are done. The first exception thrown by f is rethrown here.
+	//! A call made while the pool is already busy, from a task or from
+	//! another thread, runs everything on the calling thread instead.
+	void parallelFor(size_t n, const std::function<void(size_t)>& f);
+
+	//! Pool with one thread per core shared by the players
+	static ThreadPool& shared();
+
+private:
+	struct Queue {
+		std::mutex m;
+		std::deque<size_t> tasks;
+	};
+
+	void worker(size_t slot);
+	void drain(size_t slot);
+	bool pop(size_t slot, size_t& task);
+
+	std::vector<std::thread> _threads;
+	std::unique_ptr<Queue[]> _queues;
+	size_t _size;
+
+	//guards everything below except the atomics
+	std::mutex _m;
+	std::condition_variable _wake;
+	std::condition_variable _done;
+	unsigned long _generation;
+	bool _stop;
+	std::exception_ptr _error;
+
+	//set before any of the job's tasks are queued
+	std::atomic<const std::function<void(size_t)>*> _job;
+	std::atomic<size_t> _pending;
+	std::atomic_flag _busy;
+};
@@ -0,0 +1,171 @@
+#include "Tournament.hpp"
+#include "Board.hpp"
+#include "Game.hpp"
+#include "Player.hpp"
+#include "PlayerFactory.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+size_t TournamentResult::games() const {
+	return wins + draws + losses;
+}
+
+double TournamentResult::score() const {
+	return games() ? (wins + 0.5 * draws) / games() : 0.5;
+}
+
+static double eloFromScore(double s) {
+	if(s <= 0.0) {
+		return -std::numeric_limits<double>::infinity();
+	}
+	if(s >= 1.0) {
+		return std::numeric_limits<double>::infinity();
+	}
+
+	return -400.0 * std::log10(1.0 / s - 1.0);
+}
+
+EloEstimate eloEstimate(const TournamentResult& r) {
+	double n = r.games();
+	double s = r.score();
+	if(n == 0) {
+		return { 0.0, -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity() };
+	}
+
+	//Wilson interval with the per game variance of win/draw/loss
+	//points, it stays finite on the side away from a perfect score
+	double var = (r.wins   * (1.0 - s) * (1.0 - s) +
+	              r.draws  * (0.5 - s) * (0.5 - s) +
+	              r.losses * s * s) / n;
+	const double z = 1.96;
+	double d = 1.0 + z * z / n;
+	double center = (s + z * z / (2 * n)) / d;
+	double margin = z / d * std::sqrt(var / n + z * z / (4 * n * n));
+
+	return { eloFromScore(s), eloFromScore(center - margin), eloFromScore(center + margin) };
+}
+
+//! Forwards to a player owned elsewhere, so a worker's players outlive
+//! the Games that use them
+namespace {
+class Borrowed : public Player {
+public:
+	explicit Borrowed(Player& p) : _p(p) {}
+	virtual size_t makeMove(const Board& b, Board::Player p) { return _p.makeMove(b, p); }
+
+private:
+	Player& _p;
+};
+}
+
+static std::unique_ptr<Player> borrow(Player& p) {
+	return std::unique_ptr<Player>(new Borrowed(p));
+}
+
+Tournament::Tournament(const std::string& first, const std::string& second, size_t width, size_t height,
+                       size_t winLength)
+	: _first(first), _second(second), _width(width), _height(height), _winLength(winLength)
+{
+	if(winLength < 2 || winLength > 32) {
+		throw std::invalid_argument("Win length must be between 2 and 32");
+	}
+
+	//fail here rather than on a worker thread, the first run's calling
+	//thread then plays with these
+	_firstPlayer = makePlayer(first);
+	_secondPlayer = makePlayer(second);
+}
+
+TournamentResult Tournament::run(size_t games, size_t threads, const Progress& progress, const MoveStats& moveStats) {
+	if(threads == 0) {
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	threads = std::min(threads, std::max<size_t>(games, 1));
+
+	TournamentResult total = { 0, 0, 0, 0, 0.0 };
+	std::mutex m;
+	std::atomic<size_t> next(0);
+	std::exception_ptr error;
+
+	auto start = std::chrono::steady_clock::now();
+
+	auto work = [&](bool caller) {
+		try {
+			std::unique_ptr<Player> first = caller && _firstPlayer ? std::move(_firstPlayer) : makePlayer(_first);
+			std::unique_ptr<Player> second = caller && _secondPlayer ? std::move(_secondPlayer) : makePlayer(_second);
+
+			for(size_t i; (i = next.fetch_add(1)) < games;) {
+				bool firstIsP1 = i % 2 == 0;
+
+				Game g(Board(_width, _height, _winLength), borrow(firstIsP1 ? *first : *second),
+				                               borrow(firstIsP1 ? *second : *first));
+				Board::Player w;
+				size_t moves = 0;
+				do {
+					bool firstMoves = (g.toMove() == Board::Player::P1) == firstIsP1;
+					w = g.step();
+
+					const SearchStats* stats = (firstMoves ? first : second)->lastStats();
+					if(moveStats && stats) {
+						std::lock_guard<std::mutex> lock(m);
+						moveStats(i, moves, firstMoves, *stats);
+					}
+
+					moves++;
+				} while(w == Board::Player::NONE);
+
+				Board::Player firstSeat = firstIsP1 ? Board::Player::P1 : Board::Player::P2;
+
+				std::lock_guard<std::mutex> lock(m);
+				if(w == Board::Player::E) {
+					total.draws++;
+				} else if(w == firstSeat) {
+					total.wins++;
+				} else {
+					total.losses++;
+				}
+				total.moves += moves;
+				total.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+				if(progress) {
+					progress(total);
+				}
+			}
+		} catch(...) {
+			std::lock_guard<std::mutex> lock(m);
+			if(!error) {
+				error = std::current_exception();
+			}
+			//stop the other workers early
+			next = games;
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for(size_t i = 1; i < threads; i++) {
+		workers.emplace_back(work, false);
+	}
+	work(true);
+	for(auto& t : workers) {
+		t.join();
+	}
+
+	if(error) {
+		std::rethrow_exception(error);
+	}
+
+	total.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return total;
+}
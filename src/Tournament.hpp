@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Player.hpp"
+#include "SearchStats.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+
+//! Totals from the point of view of the first player
+struct TournamentResult {
+	size_t wins;
+	size_t draws;
+	size_t losses;
+	size_t moves;
+	double seconds;
+
+	size_t games() const;
+	//! Points per game, a draw is worth half a win
+	double score() const;
+};
+
+//! Elo difference of the first player over the second, with the bounds
+//! of a 95% confidence interval. elo and one bound are infinite when one
+//! side scored every point.
+struct EloEstimate {
+	double elo;
+	double low;
+	double high;
+};
+
+EloEstimate eloEstimate(const TournamentResult& r);
+
+//! Plays two player specs (see makePlayer) against each other on a
+//! number of threads. Each thread has its own pair of players and
+//! plays whole games one after another. The first player takes P1 in
+//! even numbered games and P2 in odd ones.
+class Tournament {
+public:
+	//! Throws std::invalid_argument if either spec is malformed or
+	//! winLength isn't between 2 and 32
+	Tournament(const std::string& first, const std::string& second, size_t width = 7, size_t height = 6,
+	           size_t winLength = 4);
+
+	//! Called after every game with the running totals, never from
+	//! two threads at once
+	typedef std::function<void(const TournamentResult&)> Progress;
+
+	//! Called after every move by a player that keeps stats, with the
+	//! game number, the ply (0 for the first move of a game) and whether
+	//! the first player made the move. Never from two threads at once.
+	typedef std::function<void(size_t game, size_t ply, bool first, const SearchStats& stats)> MoveStats;
+
+	//! Plays games games on threads threads, 0 meaning one per core
+	TournamentResult run(size_t games, size_t threads = 0, const Progress& progress = Progress(),
+	                     const MoveStats& moveStats = MoveStats());
+
+private:
+	std::string _first;
+	std::string _second;
+	size_t _width;
+	size_t _height;
+	size_t _winLength;
+
+	//built by the constructor to check the specs, then handed to the
+	//calling thread of the first run
+	std::unique_ptr<Player> _firstPlayer;
+	std::unique_ptr<Player> _secondPlayer;
+};
@@ -0,0 +1,130 @@
+#include "TranspositionTable.hpp"
+
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+// data word layout:
+// [0, 32)  value bits
+// [32, 40) depth
+// [40, 48) bound
+// [48, 56) move
+// [56, 64) generation
+
+static inline uint64_t pack(const TranspositionTable::Entry& e, unsigned char generation) {
+	uint32_t value;
+	std::memcpy(&value, &e.value, sizeof(value));
+
+	return uint64_t(value) |
+	       uint64_t(e.depth) << 32 |
+	       uint64_t(e.bound) << 40 |
+	       uint64_t(e.move)  << 48 |
+	       uint64_t(generation) << 56;
+}
+
+static inline TranspositionTable::Entry unpack(uint64_t d) {
+	TranspositionTable::Entry e;
+	uint32_t value = uint32_t(d);
+	std::memcpy(&e.value, &value, sizeof(value));
+
+	e.depth = d >> 32;
+	e.bound = TranspositionTable::Bound((d >> 40) & 0xFF);
+	e.move  = d >> 48;
+
+	return e;
+}
+
+TranspositionTable::TranspositionTable(size_t megabytes)
+	: _storage(), _buckets(nullptr), _bits(0), _generation(0)
+{
+	size_t bytes = megabytes << 20;
+	if(bytes < sizeof(Bucket)) {
+		throw std::invalid_argument("Transposition table needs at least one bucket");
+	}
+
+	while((sizeof(Bucket) << (_bits + 1)) <= bytes) {
+		_bits++;
+	}
+
+	//operator new only guarantees alignment for over-aligned types from C++17
+	_storage.reset(new unsigned char[(sizeof(Bucket) << _bits) + alignof(Bucket)]);
+	uintptr_t p = reinterpret_cast<uintptr_t>(_storage.get());
+	p = (p + alignof(Bucket) - 1) & ~uintptr_t(alignof(Bucket) - 1);
+
+	_buckets = reinterpret_cast<Bucket*>(p);
+	for(size_t i = 0; i < (size_t(1) << _bits); i++) {
+		new (&_buckets[i]) Bucket();
+	}
+
+	clear();
+}
+
+size_t TranspositionTable::size() const {
+	return WAYS << _bits;
+}
+
+size_t TranspositionTable::index(uint64_t key) const {
+	//fibonacci hashing, keys don't need to be uniform in the low bits
+	return _bits == 0 ? 0 : (key * 0x9E3779B97F4A7C15ull) >> (64 - _bits);
+}
+
+void TranspositionTable::clear() {
+	for(size_t i = 0; i < (size_t(1) << _bits); i++) {
+		for(size_t w = 0; w < WAYS; w++) {
+			_buckets[i].keys[w].store(0, std::memory_order_relaxed);
+			_buckets[i].data[w].store(0, std::memory_order_relaxed);
+		}
+	}
+}
+
+void TranspositionTable::newSearch() {
+	_generation++;
+}
+
+bool TranspositionTable::probe(uint64_t key, Entry& e) const {
+	const Bucket& b = _buckets[index(key)];
+
+	for(size_t w = 0; w < WAYS; w++) {
+		uint64_t d = b.data[w].load(std::memory_order_relaxed);
+		uint64_t k = b.keys[w].load(std::memory_order_relaxed);
+
+		if((k ^ d) == key && Bound((d >> 40) & 0xFF) != Bound::NONE) {
+			e = unpack(d);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void TranspositionTable::store(uint64_t key, const Entry& e) {
+	Bucket& b = _buckets[index(key)];
+
+	size_t victim = 0;
+	int victimScore = 1 << 30;
+	for(size_t w = 0; w < WAYS; w++) {
+		uint64_t d = b.data[w].load(std::memory_order_relaxed);
+		uint64_t k = b.keys[w].load(std::memory_order_relaxed);
+
+		if((k ^ d) == key) {
+			Entry old = unpack(d);
+			if(e.depth < old.depth && e.bound != Bound::EXACT && (d >> 56) == _generation) {
+				return;
+			}
+			victim = w;
+			break;
+		}
+
+		//empty slots go first, then stale ones, then shallow ones
+		int score = Bound((d >> 40) & 0xFF) == Bound::NONE ? -1 :
+		            int((d >> 32) & 0xFF) + ((d >> 56) == _generation ? 256 : 0);
+		if(score < victimScore) {
+			victimScore = score;
+			victim = w;
+		}
+	}
+
+	uint64_t d = pack(e, _generation);
+	b.keys[victim].store(key ^ d, std::memory_order_relaxed);
+	b.data[victim].store(d, std::memory_order_relaxed);
+}
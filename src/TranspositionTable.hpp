@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+//! Fixed size hash table of search results. Entries are grouped in
+//! cache line sized buckets of four, a lookup touches a single line.
+//! Safe to share between threads: each entry is stored as two atomic
+//! words with the key xored with the data, so a torn write reads back
+//! as a miss instead of a wrong result.
+class TranspositionTable {
+public:
+	enum class Bound : unsigned char { NONE = 0, EXACT = 1, LOWER = 2, UPPER = 3 };
+
+	struct Entry {
+		float value;
+		unsigned char depth;
+		Bound bound;
+		unsigned char move;
+	};
+
+	//! Uses at most megabytes of memory, rounded down to a power of two
+	explicit TranspositionTable(size_t megabytes);
+
+	bool probe(uint64_t key, Entry& e) const;
+
+	//! Replaces the same position if the new result is at least as deep
+	//! or exact, otherwise the shallowest entry of the bucket, preferring
+	//! entries left over from previous searches
+	void store(uint64_t key, const Entry& e);
+
+	//! Marks the start of a new search, older entries age out first
+	void newSearch();
+	void clear();
+
+	//! Number of entries
+	size_t size() const;
+
+private:
+	static const size_t WAYS = 4;
+
+	struct alignas(64) Bucket {
+		std::atomic<uint64_t> keys[WAYS];
+		std::atomic<uint64_t> data[WAYS];
+	};
+
+	size_t index(uint64_t key) const;
+
+	std::unique_ptr<unsigned char[]> _storage;
+	Bucket* _buckets;
+	unsigned _bits;
+	unsigned char _generation;
+};
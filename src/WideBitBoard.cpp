@@ -0,0 +1,6 @@
+#include "WideBitBoard.hpp"
+
+template class BasicWideBitBoard<2>;
+template class BasicWideBitBoard<3>;
+template class BasicWideBitBoard<4>;
+template class BasicWideBitBoard<8>;
@@ -0,0 +1,384 @@
+#pragma once
+
+#include "Board.hpp"
+#include "MoveList.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+//! Bitboard for boards too big for BitBoard, spread over N 64 bit words.
+//! Same layout as BitBoard: cell (x, y) is bit x * (height + 1) + y and
+//! the top bit of every column is a sentinel that stays clear, so
+//! shifted lines can't run from one column into the next. Runs of
+//! winLength are found by folding with multi-word shifts, see
+//! runStarts. Mirrors the interface of Board, so the generic rollout and
+//! search code runs on it unchanged.
+template<size_t N>
+class BasicWideBitBoard {
+public:
+	typedef MoveList Moves;
+
+	//! True if a width x height board can be represented
+	static bool fits(size_t width, size_t height);
+
+	BasicWideBitBoard(size_t width, size_t height, size_t winLength = 4);
+	explicit BasicWideBitBoard(const Board& b);
+
+	Board::Player operator()(size_t x, size_t y) const;
+
+	void reset();
+
+	//! Same contract as Board::put
+	size_t put(Board::Player p, size_t x);
+	void unput(size_t x);
+
+	Board::Player winner() const;
+	bool isColumnFull(size_t x) const;
+	bool isFull() const;
+	bool isGameOver() const;
+
+	const Moves& legalMoves() const;
+	std::string toString() const;
+
+	size_t width() const;
+	size_t height() const;
+	size_t winLength() const;
+
+	//! True if pieces, M words of them, contain k in a row on a board of
+	//! the given height
+	template<size_t M>
+	static bool hasRun(const uint64_t* pieces, size_t height, size_t k);
+
+private:
+	//! out = in >> s over M words
+	template<size_t M>
+	static void shiftRight(const uint64_t* in, uint64_t* out, size_t s);
+
+	//! winLength in a row for p through bit i. K is the win length if
+	//! it's 4, so the folds unroll, or 0.
+	template<size_t K>
+	bool runThrough(Board::Player p, size_t i) const;
+	void pieces(Board::Player p, uint64_t* out) const;
+
+	uint64_t _position[N];
+	uint64_t _mask[N];
+	Moves _lMovs;
+	unsigned char _heights[64];
+	unsigned char _width;
+	unsigned char _height;
+	unsigned char _winLength;
+	unsigned short _filled;
+	Board::Player _winner;
+};
+
+//! Sizes that get an instantiation, see withWideBitBoard
+extern template class BasicWideBitBoard<2>;
+extern template class BasicWideBitBoard<3>;
+extern template class BasicWideBitBoard<4>;
+extern template class BasicWideBitBoard<8>;
+
+//! Calls f with a copy of b in the smallest BasicWideBitBoard that holds
+//! it and returns true, or returns false if none does. f needs a call
+//! operator templated on the board type.
+template<class F>
+bool withWideBitBoard(const Board& b, F& f);
+
+
+template<size_t N>
+bool BasicWideBitBoard<N>::fits(size_t width, size_t height) {
+	return width != 0 && width <= 64 && height != 0 && height < 255 && width * (height + 1) <= 64 * N;
+}
+
+template<size_t N>
+BasicWideBitBoard<N>::BasicWideBitBoard(size_t width, size_t height, size_t winLength)
+	: _width(width), _height(height), _winLength(winLength)
+{
+	static_assert(std::is_trivially_copyable<BasicWideBitBoard>::value, "BasicWideBitBoard must stay trivially copyable");
+	assert(fits(width, height));
+	assert(winLength >= 2 && winLength <= 32);
+
+	reset();
+}
+
+template<size_t N>
+BasicWideBitBoard<N>::BasicWideBitBoard(const Board& b)
+	: BasicWideBitBoard(b.width(), b.height(), b.winLength())
+{
+	for(size_t x = 0; x < _width; x++) {
+		for(size_t y = 0; y < _height && b(x, y) != Board::Player::E; y++) {
+			put(b(x, y), x);
+		}
+	}
+}
+
+template<size_t N>
+void BasicWideBitBoard<N>::reset() {
+	for(size_t i = 0; i < N; i++) {
+		_position[i] = 0;
+		_mask[i] = 0;
+	}
+
+	_lMovs.clear();
+	for(size_t x = 0; x < _width; x++) {
+		_heights[x] = 0;
+		_lMovs.push_back(x);
+	}
+
+	_filled = 0;
+	_winner = Board::Player::E;
+}
+
+template<size_t N>
+inline size_t BasicWideBitBoard<N>::width() const {
+	return _width;
+}
+
+template<size_t N>
+inline size_t BasicWideBitBoard<N>::height() const {
+	return _height;
+}
+
+template<size_t N>
+inline size_t BasicWideBitBoard<N>::winLength() const {
+	return _winLength;
+}
+
+template<size_t N>
+inline Board::Player BasicWideBitBoard<N>::operator()(size_t x, size_t y) const {
+	assert(x < _width);
+	assert(y < _height);
+
+	size_t i = x * (_height + 1) + y;
+	uint64_t bit = uint64_t(1) << (i % 64);
+	return !(_mask[i / 64] & bit)    ? Board::Player::E  :
+	       (_position[i / 64] & bit) ? Board::Player::P1 :
+	                                   Board::Player::P2;
+}
+
+template<size_t N>
+inline size_t BasicWideBitBoard<N>::put(Board::Player p, size_t x) {
+	assert(x < _width);
+
+	if(p == Board::Player::E || _heights[x] >= _height) {
+		return _height;
+	}
+
+	size_t y = _heights[x]++;
+	size_t i = x * (_height + 1) + y;
+	uint64_t bit = uint64_t(1) << (i % 64);
+	_mask[i / 64] |= bit;
+	if(p == Board::Player::P1) {
+		_position[i / 64] |= bit;
+	}
+	_filled++;
+
+	if(_heights[x] >= _height) {
+		_lMovs.erase(x);
+	}
+
+	if(_winner == Board::Player::E && (_winLength == 4 ? runThrough<4>(p, i) : runThrough<0>(p, i))) {
+		_winner = p;
+	}
+
+	return y;
+}
+
+template<size_t N>
+inline void BasicWideBitBoard<N>::unput(size_t x) {
+	assert(x < _width);
+	assert(_heights[x] != 0);
+
+	if(_heights[x] >= _height) {
+		_lMovs.push_back(x);
+	}
+
+	size_t i = x * (_height + 1) + --_heights[x];
+	uint64_t bit = ~(uint64_t(1) << (i % 64));
+	_mask[i / 64] &= bit;
+	_position[i / 64] &= bit;
+	_filled--;
+
+	if(_winner != Board::Player::E) {
+		//rare, only when search takes back a won position
+		uint64_t own[N];
+		pieces(_winner, own);
+		if(!hasRun<N>(own, _height, _winLength)) {
+			Board::Player other = _winner == Board::Player::P1 ? Board::Player::P2 : Board::Player::P1;
+			pieces(other, own);
+			_winner = hasRun<N>(own, _height, _winLength) ? other : Board::Player::E;
+		}
+	}
+}
+
+template<size_t N>
+inline Board::Player BasicWideBitBoard<N>::winner() const {
+	return _winner;
+}
+
+template<size_t N>
+inline bool BasicWideBitBoard<N>::isColumnFull(size_t x) const {
+	assert(x < _width);
+	return _heights[x] >= _height;
+}
+
+template<size_t N>
+inline bool BasicWideBitBoard<N>::isFull() const {
+	return _filled == _width * _height;
+}
+
+template<size_t N>
+inline bool BasicWideBitBoard<N>::isGameOver() const {
+	return _winner != Board::Player::E || isFull();
+}
+
+template<size_t N>
+inline const typename BasicWideBitBoard<N>::Moves& BasicWideBitBoard<N>::legalMoves() const {
+	return _lMovs;
+}
+
+template<size_t N>
+inline void BasicWideBitBoard<N>::pieces(Board::Player p, uint64_t* out) const {
+	for(size_t i = 0; i < N; i++) {
+		out[i] = p == Board::Player::P1 ? _position[i] : _position[i] ^ _mask[i];
+	}
+}
+
+template<size_t N>
+template<size_t M>
+inline void BasicWideBitBoard<N>::shiftRight(const uint64_t* in, uint64_t* out, size_t s) {
+	const size_t words = s / 64;
+	const unsigned bits = s % 64;
+
+	for(size_t i = 0; i < M; i++) {
+		uint64_t lo = i + words < M ? in[i + words] : 0;
+		uint64_t hi = i + words + 1 < M ? in[i + words + 1] : 0;
+		out[i] = bits ? (lo >> bits) | (hi << (64 - bits)) : lo;
+	}
+}
+
+template<size_t N>
+template<size_t M>
+inline bool BasicWideBitBoard<N>::hasRun(const uint64_t* b, size_t height, size_t k) {
+	const size_t dirs[4] = { 1, height, height + 1, height + 2 };
+
+	//runStarts over M words
+	for(size_t d : dirs) {
+		uint64_t m[M];
+		uint64_t shifted[M];
+		for(size_t i = 0; i < M; i++) {
+			m[i] = b[i];
+		}
+
+		size_t len = 1;
+		for(; len < k; len *= 2) {
+			//the last step joins two overlapping runs of len
+			size_t s = (2 * len <= k ? len : k - len) * d;
+			shiftRight<M>(m, shifted, s);
+			for(size_t i = 0; i < M; i++) {
+				m[i] &= shifted[i];
+			}
+		}
+
+		uint64_t any = 0;
+		for(size_t i = 0; i < M; i++) {
+			any |= m[i];
+		}
+		if(any) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+template<size_t N>
+template<size_t K>
+inline bool BasicWideBitBoard<N>::runThrough(Board::Player p, size_t i) const {
+	//two words of padding for the window below
+	uint64_t own[N + 2];
+	pieces(p, own);
+	own[N] = own[N + 1] = 0;
+
+	//every line through bit i lies within reach bits of it. When that
+	//fits in two words only the window around i gets checked, with plain
+	//two word shifts as no fold reaches past one word. Leaving pieces
+	//out can't make a run, and the gaps keep lines from wrapping.
+	const size_t k = K ? K : _winLength;
+	const size_t reach = (k - 1) * (_height + 2);
+	if(2 * reach + 1 > 128) {
+		return hasRun<N>(own, _height, k);
+	}
+
+	const size_t start = i > reach ? i - reach : 0;
+	const size_t w = start / 64;
+	const unsigned s = start % 64;
+	uint64_t lo = own[w];
+	uint64_t hi = own[w + 1];
+	if(s) {
+		lo = (lo >> s) | (hi << (64 - s));
+		hi = (hi >> s) | (own[w + 2] << (64 - s));
+	}
+
+	const unsigned dirs[4] = { 1, unsigned(_height), unsigned(_height) + 1, unsigned(_height) + 2 };
+	for(unsigned d : dirs) {
+		uint64_t mlo = lo;
+		uint64_t mhi = hi;
+		for(size_t len = 1; len < k; len *= 2) {
+			unsigned t = unsigned(2 * len <= k ? len : k - len) * d;
+			mlo &= (mlo >> t) | (mhi << (64 - t));
+			mhi &= mhi >> t;
+		}
+
+		if(mlo | mhi) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+template<size_t N>
+std::string BasicWideBitBoard<N>::toString() const {
+	std::stringstream s;
+
+	for(size_t row = _height - 1; row < _height; row--) {
+		for(size_t col = 0; col < _width; col++) {
+			auto cell = (*this)(col, row);
+
+			s << (cell == Board::Player::E  ? ". " :
+			      cell == Board::Player::P1 ? "O " :
+			                                  "X ");
+		}
+		s << '\n';
+	}
+
+	for(size_t i = 0; i + 1 < 2 * size_t(_width); i++) {
+		s << '=';
+	}
+	s << '\n';
+
+	return s.str();
+}
+
+template<class F>
+bool withWideBitBoard(const Board& b, F& f) {
+	const size_t w = b.width();
+	const size_t h = b.height();
+
+	if(BasicWideBitBoard<2>::fits(w, h)) {
+		f(BasicWideBitBoard<2>(b));
+	} else if(BasicWideBitBoard<3>::fits(w, h)) {
+		f(BasicWideBitBoard<3>(b));
+	} else if(BasicWideBitBoard<4>::fits(w, h)) {
+		f(BasicWideBitBoard<4>(b));
+	} else if(BasicWideBitBoard<8>::fits(w, h)) {
+		f(BasicWideBitBoard<8>(b));
+	} else {
+		return false;
+	}
+
+	return true;
+}
@@ -1,6 +1,22 @@
 #include <gtest/gtest.h>
 
 #include "board_tests.cpp"
+#include "bitboard_tests.cpp"
+#include "fixedboard_tests.cpp"
+#include "wide_bitboard_tests.cpp"
+#include "mcts_tests.cpp"
+#include "tt_tests.cpp"
+#include "hybrid_tests.cpp"
+#include "solver_tests.cpp"
+#include "book_tests.cpp"
+#include "tournament_tests.cpp"
+#include "rollout_tests.cpp"
+#include "batch_rollout_tests.cpp"
+#include "stats_tests.cpp"
+#include "threadpool_tests.cpp"
+#include "record_tests.cpp"
+#include "server_tests.cpp"
+#include "evaluator_tests.cpp"
 
 int main(int argc, char** argv) {
 	testing::InitGoogleTest(&argc, argv);
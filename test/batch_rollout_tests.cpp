@@ -0,0 +1,70 @@
+#include "BatchRollout.hpp"
+#include "Rollout.hpp"
+#include "Random.hpp"
+#include "BitBoard.hpp"
+#include "Board.hpp"
+#include <gtest/gtest.h>
+
+static bool supported(Simd s) {
+	return s <= bestSimd();
+}
+
+TEST(BatchRollout, CountsEveryGame) {
+	BitBoard b(7, 6);
+	XorShift g(1);
+
+	for(size_t games : { 0, 1, 15, 16, 17, 1000 }) {
+		RolloutCounts r = batchRollouts(b, Board::Player::P1, Board::Player::P1, games, g);
+		ASSERT_EQ(games, r.wins + r.draws + r.losses);
+	}
+}
+
+TEST(BatchRollout, SameGamesOnEveryLevel) {
+	Board start(7, 6);
+	start.put(Board::Player::P1, 3);
+	start.put(Board::Player::P2, 3);
+	start.put(Board::Player::P1, 2);
+	BitBoard b(start);
+
+	XorShift g0(9);
+	RolloutCounts ref = batchRollouts(b, Board::Player::P1, Board::Player::P2, 5000, g0, Simd::SCALAR);
+
+	for(Simd s : { Simd::AVX2, Simd::AVX512 }) {
+		if(!supported(s)) {
+			continue;
+		}
+
+		XorShift g(9);
+		RolloutCounts r = batchRollouts(b, Board::Player::P1, Board::Player::P2, 5000, g, s);
+		EXPECT_EQ(ref.wins, r.wins);
+		EXPECT_EQ(ref.draws, r.draws);
+		EXPECT_EQ(ref.losses, r.losses);
+	}
+
+	//same games seen from the other side
+	XorShift g1(9);
+	RolloutCounts other = batchRollouts(b, Board::Player::P2, Board::Player::P2, 5000, g1);
+	EXPECT_EQ(ref.wins, other.losses);
+	EXPECT_EQ(ref.losses, other.wins);
+}
+
+TEST(BatchRollout, MatchesScalarKernel) {
+	//P1 to move and a piece away from four in column 0
+	Board start(6, 5);
+	start.put(Board::Player::P1, 0);
+	start.put(Board::Player::P2, 1);
+	start.put(Board::Player::P1, 0);
+	start.put(Board::Player::P2, 3);
+	start.put(Board::Player::P1, 0);
+	start.put(Board::Player::P2, 5);
+	BitBoard b(start);
+
+	const size_t games = 40000;
+	XorShift g(5);
+	RolloutCounts r = batchRollouts(b, Board::Player::P1, Board::Player::P1, games, g);
+	double batch = (double(r.wins) - double(r.losses)) / games;
+	double kernel = double(rollouts(b, Board::Player::P1, Board::Player::P1, games, g)) / games;
+
+	EXPECT_NEAR(kernel, batch, 0.03);
+	EXPECT_GT(batch, 0.2);
+}
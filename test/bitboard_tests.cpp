@@ -0,0 +1,86 @@
+#include "BitBoard.hpp"
+#include "Board.hpp"
+#include <gtest/gtest.h>
+
+#include <random>
+
+TEST(BitBoardTest, Fits) {
+	EXPECT_TRUE(BitBoard::fits(7, 6));
+	EXPECT_TRUE(BitBoard::fits(8, 7));
+	EXPECT_FALSE(BitBoard::fits(9, 7));
+	EXPECT_FALSE(BitBoard::fits(0, 6));
+}
+
+TEST(BitBoardTest, PutUnput) {
+	BitBoard b(7, 6);
+
+	for(size_t j = 0; j < b.height(); j++) {
+		EXPECT_EQ(b.put(Board::Player::P1, 3), j);
+	}
+	EXPECT_TRUE(b.isColumnFull(3));
+	EXPECT_EQ(b.put(Board::Player::P2, 3), b.height());
+	EXPECT_EQ(b.put(Board::Player::E, 2), b.height());
+
+	b.unput(3);
+	EXPECT_FALSE(b.isColumnFull(3));
+	EXPECT_EQ(b(3, 5), Board::Player::E);
+	EXPECT_EQ(b.put(Board::Player::P2, 3), 5);
+	EXPECT_EQ(b(3, 5), Board::Player::P2);
+}
+
+TEST(BitBoardTest, FromBoard) {
+	Board b(7, 6);
+	b.put(Board::Player::P1, 0);
+	b.put(Board::Player::P2, 0);
+	b.put(Board::Player::P1, 6);
+
+	BitBoard bb(b);
+	for(size_t i = 0; i < b.width(); i++) {
+		for(size_t j = 0; j < b.height(); j++) {
+			EXPECT_EQ(bb(i, j), b(i, j));
+		}
+	}
+}
+
+//plays the same random games on a Board and a BitBoard and
+//checks that every query agrees along the way
+static void compareRandomGames(size_t width, size_t height, unsigned seed) {
+	std::default_random_engine g(seed);
+
+	for(int game = 0; game < 200; game++) {
+		Board b(width, height);
+		BitBoard bb(width, height);
+		Board::Player p = Board::Player::P1;
+
+		while(!b.legalMoves().empty()) {
+			auto& moves = b.legalMoves();
+			size_t x = moves[std::uniform_int_distribution<size_t>(0, moves.size() - 1)(g)];
+
+			size_t y = b.put(p, x);
+			ASSERT_EQ(bb.put(p, x), y);
+			ASSERT_EQ(causedWin(bb, x, y), causedWin(b, x, y));
+			ASSERT_EQ(bb.winner(), b.winner());
+			ASSERT_EQ(bb.isFull(), b.isFull());
+			ASSERT_EQ(bb.isColumnFull(x), b.isColumnFull(x));
+
+			if(b.winner() != Board::Player::E) {
+				break;
+			}
+			p = p == Board::Player::P1 ? Board::Player::P2 : Board::Player::P1;
+		}
+
+		for(size_t i = 0; i < width; i++) {
+			for(size_t j = 0; j < height; j++) {
+				ASSERT_EQ(bb(i, j), b(i, j));
+			}
+		}
+	}
+}
+
+TEST(BitBoardTest, MatchesBoard7x6) {
+	compareRandomGames(7, 6, 42);
+}
+
+TEST(BitBoardTest, MatchesBoard8x7) {
+	compareRandomGames(8, 7, 1337);
+}
@@ -1,6 +1,12 @@
 #include "Board.hpp"
+#include "BitBoard.hpp"
+#include "WideBitBoard.hpp"
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <random>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 TEST(BoardTest, Initialization) {
@@ -428,3 +434,290 @@ TEST(BoardTest, LegalMoves) {
 	expected = { };
 	EXPECT_EQ(b.legalMoves(), expected);
 }
+
+TEST(BoardTest, ResetClearsState) {
+	Board b(7, 6);
+	for(size_t i = 0; i < 4; i++) {
+		b.put(Board::Player::P1, i);
+	}
+	for(size_t j = 0; j < b.height(); j++) {
+		b.put(Board::Player::P2, 6);
+	}
+
+	b.reset();
+	EXPECT_EQ(b.winner(), Board::Player::E);
+	EXPECT_FALSE(b.isGameOver());
+	EXPECT_FALSE(b.isColumnFull(6));
+	EXPECT_EQ(b.legalMoves().size(), b.width());
+	EXPECT_EQ(b.put(Board::Player::P1, 0), 0);
+}
+
+TEST(BoardTest, WinnerAfterUnput) {
+	Board b(7, 6);
+
+	// 1 1 1 1 with a 2 on top of the first one
+	for(size_t i = 0; i < 4; i++) {
+		b.put(Board::Player::P1, i);
+	}
+	EXPECT_EQ(b.winner(), Board::Player::P1);
+	b.put(Board::Player::P2, 0);
+	EXPECT_EQ(b.winner(), Board::Player::P1);
+
+	//removing a piece that isn't part of the line keeps the win
+	b.unput(0);
+	EXPECT_EQ(b.winner(), Board::Player::P1);
+
+	//removing any piece of the line undoes it
+	b.unput(1);
+	EXPECT_EQ(b.winner(), Board::Player::E);
+	EXPECT_FALSE(b.isGameOver());
+
+	b.put(Board::Player::P1, 1);
+	EXPECT_EQ(b.winner(), Board::Player::P1);
+	b.unput(1);
+	EXPECT_EQ(b.winner(), Board::Player::E);
+}
+
+TEST(BoardTest, IncrementalStateMatchesHistory) {
+	std::default_random_engine g(5);
+
+	for(int game = 0; game < 100; game++) {
+		Board b(7, 6);
+		std::vector<size_t> history;
+		std::vector<Board::Player> winners;
+		Board::Player p = Board::Player::P1;
+
+		while(!b.isGameOver()) {
+			auto& moves = b.legalMoves();
+			size_t x = moves[std::uniform_int_distribution<size_t>(0, moves.size() - 1)(g)];
+
+			winners.push_back(b.winner());
+			history.push_back(x);
+			b.put(p, x);
+			p = p == Board::Player::P1 ? Board::Player::P2 : Board::Player::P1;
+		}
+
+		EXPECT_TRUE(b.winner() != Board::Player::E || b.isFull());
+		EXPECT_EQ(Board(b).winner(), b.winner());
+
+		while(!history.empty()) {
+			b.unput(history.back());
+			history.pop_back();
+
+			ASSERT_EQ(b.winner(), winners.back());
+			ASSERT_FALSE(b.isGameOver());
+			winners.pop_back();
+		}
+	}
+}
+
+//! Reference for connect-k: true if p has k in a row, through (cx, cy)
+//! if that is on the board, checking every window cell by cell
+static bool bruteRun(const Board& b, Board::Player p, int k, int cx = -1, int cy = -1) {
+	const int w = b.width();
+	const int h = b.height();
+	const int dirs[4][2] = { { 1, 0 }, { 0, 1 }, { 1, 1 }, { 1, -1 } };
+
+	for(int x = 0; x < w; x++) {
+		for(int y = 0; y < h; y++) {
+			for(auto& d : dirs) {
+				bool run = true;
+				bool through = cx < 0;
+				for(int i = 0; i < k && run; i++) {
+					int px = x + i * d[0];
+					int py = y + i * d[1];
+					run = px >= 0 && px < w && py >= 0 && py < h && b(px, py) == p;
+					through |= px == cx && py == cy;
+				}
+				if(run && through) {
+					return true;
+				}
+			}
+		}
+	}
+
+	return false;
+}
+
+TEST(BoardTest, ConnectKMatchesBruteForce) {
+	const size_t sizes[][3] = {
+		{ 7, 6, 3 }, { 7, 6, 5 }, { 7, 6, 7 }, { 6, 5, 2 }, { 9, 7, 5 },
+		{ 12, 10, 6 }, { 16, 12, 5 }, { 19, 19, 8 }, { 4, 4, 4 }
+	};
+	std::default_random_engine g(22);
+
+	for(auto& size : sizes) {
+		const size_t k = size[2];
+		for(int game = 0; game < 100; game++) {
+			Board b(size[0], size[1], k);
+			BasicWideBitBoard<8> wb(b);
+			const bool bits = BitBoard::fits(b.width(), b.height());
+			BitBoard bb(bits ? b : Board(1, 1));
+
+			//random owners rather than turns, so runs of any length show up
+			while(!b.isFull()) {
+				auto& moves = b.legalMoves();
+				size_t x = moves[std::uniform_int_distribution<size_t>(0, moves.size() - 1)(g)];
+				Board::Player p = std::uniform_int_distribution<int>(0, 1)(g) ? Board::Player::P1 : Board::Player::P2;
+
+				Board::Player before = b.winner();
+				size_t y = b.put(p, x);
+				wb.put(p, x);
+
+				bool through = bruteRun(b, p, k, x, y);
+				ASSERT_EQ(through, causedWin(b, x, y)) << b.toString();
+				if(before == Board::Player::E) {
+					ASSERT_EQ(through ? p : Board::Player::E, b.winner()) << b.toString();
+				}
+				ASSERT_EQ(b.winner(), wb.winner()) << b.toString();
+
+				if(bits) {
+					bb.put(p, x);
+					ASSERT_EQ(through, causedWin(bb, x, y)) << b.toString();
+					ASSERT_EQ(bruteRun(b, Board::Player::P1, k) ? Board::Player::P1 :
+					          bruteRun(b, Board::Player::P2, k) ? Board::Player::P2 :
+					                                              Board::Player::E,
+					          bb.winner()) << b.toString();
+				}
+			}
+		}
+	}
+}
+
+TEST(BoardTest, HashIsIncremental) {
+	Board a(7, 6);
+	Board b(7, 6);
+	EXPECT_EQ(a.hash(), b.hash());
+
+	//same position through different move orders
+	a.put(Board::Player::P1, 0);
+	a.put(Board::Player::P2, 3);
+	a.put(Board::Player::P1, 6);
+	b.put(Board::Player::P1, 6);
+	b.put(Board::Player::P2, 3);
+	b.put(Board::Player::P1, 0);
+	EXPECT_EQ(a.hash(), b.hash());
+
+	uint64_t before = a.hash();
+	a.put(Board::Player::P2, 2);
+	EXPECT_NE(a.hash(), before);
+	a.unput(2);
+	EXPECT_EQ(a.hash(), before);
+
+	//colour matters
+	Board c(7, 6);
+	c.put(Board::Player::P2, 0);
+	c.put(Board::Player::P1, 3);
+	c.put(Board::Player::P2, 6);
+	EXPECT_NE(a.hash(), c.hash());
+
+	a.reset();
+	EXPECT_EQ(a.hash(), Board(7, 6).hash());
+
+	//the same stones on another geometry
+	Board d(7, 3);
+	Board e(7, 6, 3);
+	for(Board* s : { &d, &e }) {
+		s->put(Board::Player::P1, 0);
+		s->put(Board::Player::P2, 3);
+		s->put(Board::Player::P1, 6);
+	}
+	EXPECT_NE(b.hash(), d.hash());
+	EXPECT_NE(b.hash(), e.hash());
+	EXPECT_NE(Board(7, 6).hash(), Board(9, 7).hash());
+}
+
+TEST(BoardTest, CanonicalHashIgnoresMirroring) {
+	std::mt19937 gen(11);
+
+	for(size_t game = 0; game < 100; game++) {
+		Board a(7, 6);
+		Board m(7, 6);
+		Board::Player p = Board::Player::P1;
+		std::vector<size_t> moves;
+
+		while(!a.isGameOver()) {
+			size_t x = a.legalMoves()[gen() % a.legalMoves().size()];
+			a.put(p, x);
+			m.put(p, a.width() - 1 - x);
+			moves.push_back(x);
+			p = p == Board::Player::P1 ? Board::Player::P2 : Board::Player::P1;
+
+			ASSERT_EQ(a.canonicalHash(), m.canonicalHash());
+			ASSERT_TRUE(a.canonicalHash() == a.hash() || a.canonicalHash() == m.hash());
+		}
+
+		//taking moves back restores the keys exactly
+		for(size_t i = moves.size(); i-- > 0;) {
+			a.unput(moves[i]);
+			m.unput(a.width() - 1 - moves[i]);
+			ASSERT_EQ(a.canonicalHash(), m.canonicalHash());
+		}
+		ASSERT_EQ(Board(7, 6).canonicalHash(), a.canonicalHash());
+	}
+
+	//copies and resets carry both keys
+	Board a(7, 6);
+	a.put(Board::Player::P1, 0);
+	Board b(a);
+	Board c(3, 3);
+	c = a;
+	b.put(Board::Player::P2, 6);
+	c.put(Board::Player::P2, 6);
+	ASSERT_EQ(b.canonicalHash(), c.canonicalHash());
+	b.reset();
+	ASSERT_EQ(Board(7, 6).canonicalHash(), b.canonicalHash());
+}
+
+//! The smaller of b and its mirror image, cell by cell
+static std::string canonicalString(const Board& b) {
+	std::string s, m;
+	for(size_t y = 0; y < b.height(); y++) {
+		for(size_t x = 0; x < b.width(); x++) {
+			s += char('0' + (int)b(x, y));
+			m += char('0' + (int)b(b.width() - 1 - x, y));
+		}
+	}
+	return std::min(s, m);
+}
+
+TEST(BoardTest, HashCollisionsOnRandomGames) {
+	std::mt19937 gen(5);
+	std::unordered_map<uint64_t, std::string> plain;
+	std::unordered_map<uint64_t, std::string> canonical;
+
+	for(size_t game = 0; game < 3000; game++) {
+		Board b(7, 6);
+		Board::Player p = Board::Player::P1;
+
+		while(!b.isGameOver()) {
+			b.put(p, b.legalMoves()[gen() % b.legalMoves().size()]);
+			p = p == Board::Player::P1 ? Board::Player::P2 : Board::Player::P1;
+
+			//same key, same position
+			std::string s = b.toString();
+			auto it = plain.emplace(b.hash(), s).first;
+			ASSERT_EQ(it->second, s);
+
+			std::string c = canonicalString(b);
+			it = canonical.emplace(b.canonicalHash(), c).first;
+			ASSERT_EQ(it->second, c);
+		}
+	}
+
+	//tables index by the low bits, those have to spread evenly too
+	const size_t BUCKETS = 1024;
+	std::vector<size_t> counts(BUCKETS, 0);
+	for(auto& e : canonical) {
+		counts[e.first % BUCKETS]++;
+	}
+
+	double mean = double(canonical.size()) / BUCKETS;
+	double chi2 = 0;
+	for(size_t n : counts) {
+		chi2 += (n - mean) * (n - mean) / mean;
+	}
+	//1023 degrees of freedom, far beyond p = 0.001
+	ASSERT_LT(chi2, 1250.0);
+	ASSERT_GT(canonical.size(), 40000u);
+}
@@ -0,0 +1,105 @@
+#include "OpeningBook.hpp"
+#include "BookPlayer.hpp"
+#include "BitBoard.hpp"
+#include "Board.hpp"
+#include "Player.hpp"
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+//always plays the same column, to tell fallback moves apart
+class ColumnPlayer : public Player {
+public:
+	explicit ColumnPlayer(size_t x) : _x(x) {}
+	virtual size_t makeMove(const Board&, Board::Player) { return _x; }
+
+private:
+	size_t _x;
+};
+
+static std::string tempBook() {
+	return testing::TempDir() + "con4_book_test.bin";
+}
+
+TEST(OpeningBook, LookupAndMirror) {
+	BitBoard b(7, 6);
+	b.put(Board::Player::P1, 1);
+
+	bool mirrored;
+	OpeningBook::Entry e;
+	e.key = OpeningBook::key(b, Board::Player::P2, mirrored);
+	e.score = -2;
+	e.move = mirrored ? 6 - 2 : 2;
+
+	std::string path = tempBook();
+	OpeningBook::write(path, 7, 6, 1, { e });
+
+	{
+		OpeningBook book(path);
+		ASSERT_EQ(7u, book.width());
+		ASSERT_EQ(6u, book.height());
+		ASSERT_EQ(1u, book.size());
+
+		size_t move;
+		int score;
+		ASSERT_TRUE(book.lookup(b, Board::Player::P2, move, score));
+		ASSERT_EQ(2u, move);
+		ASSERT_EQ(-2, score);
+
+		//the mirror image shares the entry, with the move flipped
+		BitBoard m(7, 6);
+		m.put(Board::Player::P1, 5);
+		ASSERT_TRUE(book.lookup(m, Board::Player::P2, move, score));
+		ASSERT_EQ(4u, move);
+
+		BitBoard other(7, 6);
+		other.put(Board::Player::P1, 3);
+		ASSERT_FALSE(book.lookup(other, Board::Player::P2, move, score));
+		ASSERT_FALSE(book.lookup(BitBoard(6, 5), Board::Player::P1, move, score));
+	}
+
+	std::remove(path.c_str());
+}
+
+TEST(OpeningBook, RejectsBadFiles) {
+	ASSERT_THROW(OpeningBook(testing::TempDir() + "con4_no_such_book.bin"), std::runtime_error);
+
+	std::string path = tempBook();
+	FILE* f = std::fopen(path.c_str(), "wb");
+	std::fputs("definitely not a book", f);
+	std::fclose(f);
+
+	ASSERT_THROW(OpeningBook book(path), std::runtime_error);
+	std::remove(path.c_str());
+}
+
+TEST(BookPlayer, FallsBackOutsideBook) {
+	BitBoard start(7, 6);
+	bool mirrored;
+	OpeningBook::Entry e;
+	e.key = OpeningBook::key(start, Board::Player::P1, mirrored);
+	e.score = OpeningBook::UNKNOWN_SCORE;
+	e.move = 3;
+
+	std::string path = tempBook();
+	OpeningBook::write(path, 7, 6, 0, { e });
+
+	{
+		BookPlayer player(path, std::unique_ptr<Player>(new ColumnPlayer(0)));
+
+		Board b(7, 6);
+		ASSERT_EQ(3u, player.makeMove(b, Board::Player::P1));
+
+		b.put(Board::Player::P1, 3);
+		ASSERT_EQ(0u, player.makeMove(b, Board::Player::P2));
+
+		Board small(5, 4);
+		ASSERT_EQ(0u, player.makeMove(small, Board::Player::P1));
+	}
+
+	std::remove(path.c_str());
+}
@@ -0,0 +1,162 @@
+#include "Evaluator.hpp"
+#include "BitBoard.hpp"
+#include "Board.hpp"
+#include "HybridPlayer.hpp"
+#include "PlayerFactory.hpp"
+#include "Random.hpp"
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <stdexcept>
+
+//! The same terms, one cell and one line at a time
+static Evaluator::Terms bruteTerms(const Board& b, Board::Player p) {
+	Evaluator::Terms t = { 0, 0, 0, 0 };
+	const int w = b.width();
+	const int h = b.height();
+	const int dirs[4][2] = { { 0, 1 }, { 1, 0 }, { 1, 1 }, { 1, -1 } };
+
+	auto inside = [&](int x, int y) { return x >= 0 && x < w && y >= 0 && y < h; };
+
+	for(int x = 0; x < w; x++) {
+		for(int y = 0; y < h; y++) {
+			if(b(x, y) == p && (x == w / 2 || x == (w - 1) / 2)) {
+				t.center++;
+			}
+
+			for(auto& d : dirs) {
+				if(!inside(x + 3 * d[0], y + 3 * d[1])) {
+					continue;
+				}
+
+				int own = 0, empty = 0;
+				for(int k = 0; k < 4; k++) {
+					Board::Player c = b(x + k * d[0], y + k * d[1]);
+					own += c == p;
+					empty += c == Board::Player::E;
+				}
+				t.twos += own == 2 && empty == 2;
+			}
+
+			if(b(x, y) != Board::Player::E) {
+				continue;
+			}
+
+			//would a piece here complete four
+			bool threat = false;
+			for(auto& d : dirs) {
+				int run = 1;
+				for(int s = -1; s <= 1; s += 2) {
+					for(int k = 1; inside(x + s * k * d[0], y + s * k * d[1]) && b(x + s * k * d[0], y + s * k * d[1]) == p; k++) {
+						run++;
+					}
+				}
+				threat = threat || run >= 4;
+			}
+
+			if(threat) {
+				t.threats++;
+				t.goodThreats += (y % 2 == 0) == (p == Board::Player::P1);
+			}
+		}
+	}
+
+	return t;
+}
+
+TEST(Evaluator, MatchesBruteForce) {
+	XorShift g(7);
+	const size_t sizes[3][2] = { { 7, 6 }, { 6, 7 }, { 4, 4 } };
+
+	for(auto& s : sizes) {
+		Evaluator e(s[0], s[1]);
+
+		for(size_t game = 0; game < 200; game++) {
+			Board b(s[0], s[1]);
+			Board::Player p = Board::Player::P1;
+
+			while(!b.isGameOver()) {
+				BitBoard bb(b);
+				for(Board::Player q : { Board::Player::P1, Board::Player::P2 }) {
+					Evaluator::Terms fast = e.terms(bb, q);
+					Evaluator::Terms slow = bruteTerms(b, q);
+					ASSERT_EQ(slow.twos, fast.twos);
+					ASSERT_EQ(slow.threats, fast.threats);
+					ASSERT_EQ(slow.goodThreats, fast.goodThreats);
+					ASSERT_EQ(slow.center, fast.center);
+				}
+				ASSERT_EQ(e.raw(bb, Board::Player::P1), -e.raw(bb, Board::Player::P2));
+
+				float v = e.evaluate(bb, Board::Player::P1, p);
+				ASSERT_LE(v, Evaluator::MAX_SCORE);
+				ASSERT_GE(v, -Evaluator::MAX_SCORE);
+
+				b.put(p, b.legalMoves()[g.below(b.legalMoves().size())]);
+				p = p == Board::Player::P1 ? Board::Player::P2 : Board::Player::P1;
+			}
+		}
+	}
+}
+
+TEST(Evaluator, Scores) {
+	Evaluator e(7, 6);
+	BitBoard b(7, 6);
+	ASSERT_EQ(0.0f, e.evaluate(b, Board::Player::P1, Board::Player::P1));
+
+	b.put(Board::Player::P1, 3);
+	ASSERT_GT(e.evaluate(b, Board::Player::P1, Board::Player::P2), 0.0f);
+	ASSERT_LT(e.evaluate(b, Board::Player::P2, Board::Player::P2), 0.0f);
+
+	//P1 threatens the bottom row, which P2 has to block right away
+	b.put(Board::Player::P2, 3);
+	b.put(Board::Player::P1, 1);
+	b.put(Board::Player::P2, 1);
+	b.put(Board::Player::P1, 2);
+	ASSERT_EQ(Evaluator::MAX_SCORE, e.evaluate(b, Board::Player::P1, Board::Player::P1));
+	ASSERT_EQ(-Evaluator::MAX_SCORE, e.evaluate(b, Board::Player::P2, Board::Player::P1));
+	ASSERT_GT(e.evaluate(b, Board::Player::P1, Board::Player::P2), 0.0f);
+
+	ASSERT_EQ(2, e.terms(b, Board::Player::P1).threats);
+	ASSERT_EQ(2, e.terms(b, Board::Player::P1).goodThreats);
+}
+
+TEST(HybridPlayerTest, EvaluationBlocksAndWins) {
+	Board b(7, 6);
+	b.put(Board::Player::P2, 3);
+	b.put(Board::Player::P2, 3);
+	b.put(Board::Player::P2, 3);
+	b.put(Board::Player::P1, 0);
+	b.put(Board::Player::P1, 6);
+
+	//no rollouts at all, leaves are scored statically
+	HybridPlayer fixed(0, 4, 1);
+	fixed.setEvaluation(true);
+	ASSERT_EQ(3u, fixed.makeMove(b, Board::Player::P1));
+	ASSERT_EQ(0u, fixed.lastStats()->counters.playouts);
+	ASSERT_EQ(3u, fixed.makeMove(b, Board::Player::P2));
+	ASSERT_EQ(1.0f, fixed.lastStats()->score);
+
+	HybridPlayer timed(std::chrono::milliseconds(30), 1);
+	timed.setEvaluation(true);
+	ASSERT_EQ(3u, timed.makeMove(b, Board::Player::P1));
+
+	//switching evaluation on doesn't read leaves scored as draws
+	Board open(7, 6);
+	open.put(Board::Player::P1, 3);
+	open.put(Board::Player::P2, 0);
+	open.put(Board::Player::P1, 3);
+	HybridPlayer fresh(0, 4, 1);
+	fresh.setEvaluation(true);
+	fresh.makeMove(open, Board::Player::P2);
+	HybridPlayer switched(0, 4, 1);
+	switched.makeMove(open, Board::Player::P2);
+	ASSERT_EQ(0.0f, switched.lastStats()->score);
+	switched.setEvaluation(true);
+	switched.makeMove(open, Board::Player::P2);
+	ASSERT_NE(0.0f, fresh.lastStats()->score);
+	ASSERT_EQ(fresh.lastStats()->score, switched.lastStats()->score);
+
+	ASSERT_TRUE(makePlayer("hybrid:100,2,eval") != nullptr);
+	ASSERT_TRUE(makePlayer("hybrid:20ms,eval") != nullptr);
+	ASSERT_THROW(makePlayer("hybrid:eval"), std::invalid_argument);
+}
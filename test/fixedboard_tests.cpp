@@ -0,0 +1,108 @@
+#include "FixedBoard.hpp"
+#include "Board.hpp"
+#include "MoveList.hpp"
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+TEST(FixedBoardTest, Initialization) {
+	FixedBoard<7, 6> b;
+
+	ASSERT_EQ(b.width(), 7);
+	ASSERT_EQ(b.height(), 6);
+	EXPECT_EQ(b.legalMoves().size(), 7);
+
+	for(size_t i = 0; i < b.width(); i++) {
+		for(size_t j = 0; j < b.height(); j++) {
+			EXPECT_EQ(b(i, j), Board::Player::E);
+		}
+	}
+}
+
+TEST(FixedBoardTest, LegalMoves) {
+	FixedBoard<5, 1> b;
+	std::vector<size_t> expected;
+
+	b.put(Board::Player::P1, 0);
+	b.put(Board::Player::P1, 3);
+	expected = { 1, 2, 4 };
+	EXPECT_EQ(std::vector<size_t>(b.legalMoves().begin(), b.legalMoves().end()), expected);
+
+	b.unput(0);
+	expected = { 1, 2, 4, 0 };
+	EXPECT_EQ(std::vector<size_t>(b.legalMoves().begin(), b.legalMoves().end()), expected);
+}
+
+TEST(FixedBoardTest, CopyIsIndependent) {
+	FixedBoard<7, 6> b;
+	b.put(Board::Player::P1, 3);
+
+	FixedBoard<7, 6> b2 = b;
+	b2.put(Board::Player::P2, 3);
+
+	EXPECT_EQ(b(3, 1), Board::Player::E);
+	EXPECT_EQ(b2(3, 1), Board::Player::P2);
+
+	b2 = b;
+	EXPECT_EQ(b2(3, 1), Board::Player::E);
+}
+
+TEST(FixedBoardTest, MatchesBoard) {
+	std::default_random_engine g(99);
+
+	for(int game = 0; game < 200; game++) {
+		Board b(7, 6);
+		FixedBoard<7, 6> fb;
+		Board::Player p = Board::Player::P1;
+
+		while(!b.legalMoves().empty()) {
+			auto& moves = b.legalMoves();
+			size_t x = moves[std::uniform_int_distribution<size_t>(0, moves.size() - 1)(g)];
+
+			size_t y = b.put(p, x);
+			ASSERT_EQ(fb.put(p, x), y);
+			ASSERT_EQ(causedWin(fb, x, y), causedWin(b, x, y));
+			ASSERT_EQ(fb.winner(), b.winner());
+			ASSERT_EQ(fb.isFull(), b.isFull());
+
+			if(b.winner() != Board::Player::E) {
+				break;
+			}
+			p = p == Board::Player::P1 ? Board::Player::P2 : Board::Player::P1;
+		}
+
+		FixedBoard<7, 6> converted(b);
+		for(size_t i = 0; i < b.width(); i++) {
+			for(size_t j = 0; j < b.height(); j++) {
+				ASSERT_EQ(fb(i, j), b(i, j));
+				ASSERT_EQ(converted(i, j), b(i, j));
+			}
+		}
+	}
+}
+
+TEST(MoveListTest, CenterFirst) {
+	Board b(7, 6);
+	std::vector<size_t> expected = { 3, 2, 4, 1, 5, 0, 6 };
+	MoveList m = centerFirstMoves(b);
+	ASSERT_EQ(expected, std::vector<size_t>(m.begin(), m.end()));
+
+	for(size_t i = 0; i < 6; i++) {
+		b.put(Board::Player::P1, 2);
+	}
+	expected = { 5, 3, 4, 1, 0, 6 };
+	m = centerFirstMoves(b, 5);
+	ASSERT_EQ(expected, std::vector<size_t>(m.begin(), m.end()));
+
+	//a full column asked for first is left out
+	expected = { 3, 4, 1, 5, 0, 6 };
+	m = centerFirstMoves(b, 2);
+	ASSERT_EQ(expected, std::vector<size_t>(m.begin(), m.end()));
+
+	FixedBoard<6, 4> fb;
+	expected = { 3, 2, 4, 1, 5, 0 };
+	m = centerFirstMoves(fb);
+	ASSERT_EQ(expected, std::vector<size_t>(m.begin(), m.end()));
+}
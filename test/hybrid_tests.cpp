@@ -0,0 +1,109 @@
+#include "HybridPlayer.hpp"
+#include "Board.hpp"
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+TEST(HybridPlayerTest, FixedBlocksImmediateLoss) {
+	Board b(7, 6);
+	b.put(Board::Player::P2, 3);
+	b.put(Board::Player::P2, 3);
+	b.put(Board::Player::P2, 3);
+	b.put(Board::Player::P1, 0);
+	b.put(Board::Player::P1, 6);
+
+	HybridPlayer p(2000, 3, 1);
+	EXPECT_EQ(p.makeMove(b, Board::Player::P1), 3);
+}
+
+TEST(HybridPlayerTest, TimedTakesImmediateWin) {
+	Board b(7, 6);
+	b.put(Board::Player::P2, 1);
+	b.put(Board::Player::P2, 2);
+	b.put(Board::Player::P2, 3);
+
+	HybridPlayer p(std::chrono::milliseconds(50), 1);
+	size_t move = p.makeMove(b, Board::Player::P2);
+	EXPECT_TRUE(move == 0 || move == 4);
+}
+
+TEST(HybridPlayerTest, TimedRespectsBudget) {
+	Board b(7, 6);
+	b.put(Board::Player::P1, 3);
+
+	HybridPlayer p(std::chrono::milliseconds(100), 1);
+
+	auto start = std::chrono::steady_clock::now();
+	size_t move = p.makeMove(b, Board::Player::P2);
+	auto elapsed = std::chrono::steady_clock::now() - start;
+
+	EXPECT_LT(move, b.width());
+	EXPECT_LT(elapsed, std::chrono::milliseconds(250));
+}
+
+TEST(HybridPlayerTest, TimedFindsForcedWin) {
+	// . . 2 2 . . .
+	// . . 1 1 . . .
+	//P1 wins by playing 1 or 4, making an open three on the bottom row
+	Board b(7, 6);
+	b.put(Board::Player::P1, 2);
+	b.put(Board::Player::P1, 3);
+	b.put(Board::Player::P2, 2);
+	b.put(Board::Player::P2, 3);
+
+	HybridPlayer p(std::chrono::milliseconds(200), 1);
+	size_t move = p.makeMove(b, Board::Player::P1);
+	EXPECT_TRUE(move == 1 || move == 4);
+}
+
+TEST(HybridPlayerTest, TimedStopsOnceDecided) {
+	//P2 threatens both ends of the bottom row, every move of P1's loses
+	Board b(7, 6);
+	b.put(Board::Player::P2, 1);
+	b.put(Board::Player::P2, 2);
+	b.put(Board::Player::P2, 3);
+
+	HybridPlayer p(std::chrono::milliseconds(2000), 1);
+
+	auto start = std::chrono::steady_clock::now();
+	size_t move = p.makeMove(b, Board::Player::P1);
+	auto elapsed = std::chrono::steady_clock::now() - start;
+
+	EXPECT_LT(move, b.width());
+	EXPECT_EQ(-1, p.lastStats()->score);
+	EXPECT_LT(elapsed, std::chrono::milliseconds(500));
+}
+
+TEST(HybridPlayerTest, SearchesBoardsWiderThanAMoveList) {
+	Board b(70, 4);
+	b.put(Board::Player::P2, 66);
+	b.put(Board::Player::P2, 66);
+	b.put(Board::Player::P2, 66);
+	b.put(Board::Player::P1, 0);
+	b.put(Board::Player::P1, 69);
+
+	HybridPlayer p(700, 2, 1);
+	EXPECT_EQ(66u, p.makeMove(b, Board::Player::P1));
+}
+
+TEST(HybridPlayerTest, TableKeepsBoardSizesApart) {
+	//the same stones on two sizes, P2 threatens to finish column 0
+	//on 7x6 while on 7x3 that column is already full
+	Board small(7, 3);
+	Board b(7, 6);
+	for(Board* s : { &small, &b }) {
+		s->put(Board::Player::P2, 0);
+		s->put(Board::Player::P2, 0);
+		s->put(Board::Player::P2, 0);
+		s->put(Board::Player::P1, 3);
+		s->put(Board::Player::P1, 4);
+	}
+
+	//without the solver, which would take the small board
+	for(size_t run = 0; run < 10; run++) {
+		HybridPlayer p(70, 3, 1);
+		p.setSolverThreshold(0);
+		p.makeMove(small, Board::Player::P1);
+		ASSERT_EQ(0u, p.makeMove(b, Board::Player::P1));
+	}
+}
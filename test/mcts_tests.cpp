@@ -0,0 +1,78 @@
+#include "MCTSPlayer.hpp"
+#include "RandomPlayer.hpp"
+#include "Board.hpp"
+#include "Game.hpp"
+#include <gtest/gtest.h>
+
+#include <memory>
+
+TEST(MCTSPlayerTest, TakesImmediateWin) {
+	Board b(7, 6);
+	b.put(Board::Player::P1, 1);
+	b.put(Board::Player::P1, 2);
+	b.put(Board::Player::P1, 3);
+	b.put(Board::Player::P2, 1);
+	b.put(Board::Player::P2, 2);
+	b.put(Board::Player::P2, 3);
+
+	MCTSPlayer p(2000);
+	size_t move = p.makeMove(b, Board::Player::P1);
+	EXPECT_TRUE(move == 0 || move == 4);
+}
+
+TEST(MCTSPlayerTest, BlocksImmediateLoss) {
+	Board b(7, 6);
+	b.put(Board::Player::P2, 3);
+	b.put(Board::Player::P2, 3);
+	b.put(Board::Player::P2, 3);
+	b.put(Board::Player::P1, 0);
+	b.put(Board::Player::P1, 6);
+
+	MCTSPlayer p(4000);
+	EXPECT_EQ(p.makeMove(b, Board::Player::P1), 3);
+}
+
+TEST(MCTSPlayerTest, ReusesTreeOverWholeGame) {
+	//a small pool forces compaction and exhaustion along the way
+	Game g(Board(7, 6), std::unique_ptr<Player>(new MCTSPlayer(500, 2000)),
+	                    std::unique_ptr<Player>(new RandomPlayer()));
+
+	Board::Player winner;
+	while((winner = g.step()) == Board::Player::NONE);
+
+	EXPECT_TRUE(g.board().isGameOver());
+	EXPECT_EQ(winner, g.board().winner());
+}
+
+TEST(MCTSPlayerTest, BeatsRandom) {
+	int wins = 0;
+	for(int i = 0; i < 10; i++) {
+		Game g(Board(7, 6), std::unique_ptr<Player>(new MCTSPlayer(1000)),
+		                    std::unique_ptr<Player>(new RandomPlayer()));
+
+		Board::Player winner;
+		while((winner = g.step()) == Board::Player::NONE);
+		wins += winner == Board::Player::P1;
+	}
+
+	EXPECT_GE(wins, 8);
+}
+
+TEST(MCTSPlayerTest, ParallelSearch) {
+	Board b(7, 6);
+	b.put(Board::Player::P2, 3);
+	b.put(Board::Player::P2, 3);
+	b.put(Board::Player::P2, 3);
+	b.put(Board::Player::P1, 0);
+	b.put(Board::Player::P1, 6);
+
+	MCTSPlayer p(20000, 1 << 16, 1.41f, 4);
+	EXPECT_EQ(p.makeMove(b, Board::Player::P1), 3);
+
+	Game g(Board(7, 6), std::unique_ptr<Player>(new MCTSPlayer(2000, 1 << 14, 1.41f, 4)),
+	                    std::unique_ptr<Player>(new RandomPlayer()));
+
+	Board::Player winner;
+	while((winner = g.step()) == Board::Player::NONE);
+	EXPECT_EQ(winner, g.board().winner());
+}
@@ -0,0 +1,170 @@
+#include "GameRecord.hpp"
+#include "Game.hpp"
+#include "Board.hpp"
+#include "RandomPlayer.hpp"
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static std::string tempRecords() {
+	return testing::TempDir() + "con4_records_test.bin";
+}
+
+static bool sameBoard(const Board& a, const Board& b) {
+	if(a.width() != b.width() || a.height() != b.height()) {
+		return false;
+	}
+	for(size_t x = 0; x < a.width(); x++) {
+		for(size_t y = 0; y < a.height(); y++) {
+			if(a(x, y) != b(x, y)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+TEST(GameRecord, RecordAndReplay) {
+	std::string path = tempRecords();
+	std::vector<Board> finals;
+	std::vector<Board::Player> results;
+
+	{
+		GameRecordWriter w(path);
+		for(size_t i = 0; i < 50; i++) {
+			//odd widths leave a half filled byte at the end of some games
+			size_t width = 4 + i % 4;
+			Game g(Board(width, 4), std::unique_ptr<Player>(new RandomPlayer()),
+			                        std::unique_ptr<Player>(new RandomPlayer()));
+			g.record(w, "random", i % 2 ? "rnd" : "");
+
+			Board::Player r;
+			while((r = g.step()) == Board::Player::NONE);
+
+			finals.push_back(g.board());
+			results.push_back(r);
+		}
+		ASSERT_EQ(50u, w.games());
+		w.flush();
+	}
+
+	GameRecordFile f(path);
+	size_t i = 0;
+	for(GameRecord r : f) {
+		ASSERT_LT(i, finals.size());
+		ASSERT_EQ(finals[i].width(), r.width());
+		ASSERT_EQ(4u, r.height());
+		ASSERT_EQ(results[i], r.result());
+		ASSERT_EQ("random", r.player1());
+		ASSERT_EQ(i % 2 ? "rnd" : "", r.player2());
+		ASSERT_TRUE(sameBoard(finals[i], r.replay()));
+
+		Board empty = r.replay(0);
+		ASSERT_TRUE(empty.legalMoves().size() == empty.width());
+		i++;
+	}
+	ASSERT_EQ(50u, i);
+
+	std::remove(path.c_str());
+}
+
+TEST(GameRecord, UnfinishedAndEmpty) {
+	std::string path = tempRecords();
+	{
+		GameRecordWriter w(path);
+	}
+	{
+		GameRecordFile f(path);
+		ASSERT_TRUE(f.begin() == f.end());
+	}
+
+	{
+		GameRecordWriter w(path);
+		w.begin(16, 2, "a", "b");
+		w.move(15);
+		w.move(0);
+		w.move(15);
+		w.end(Board::Player::NONE);
+
+		//dropped, it never ended
+		w.begin(7, 6, "c", "d");
+		w.move(3);
+
+		ASSERT_THROW(w.begin(17, 6, "a", "b"), std::invalid_argument);
+	}
+
+	GameRecordFile f(path);
+	auto it = f.begin();
+	ASSERT_TRUE(it != f.end());
+	GameRecord r = *it;
+	ASSERT_EQ(Board::Player::NONE, r.result());
+	ASSERT_EQ(3u, r.moves());
+	ASSERT_EQ(15u, r.move(0));
+	ASSERT_EQ(0u, r.move(1));
+	ASSERT_EQ(15u, r.move(2));
+
+	Board b = r.replay(2);
+	ASSERT_EQ(Board::Player::P1, b(15, 0));
+	ASSERT_EQ(Board::Player::P2, b(0, 0));
+	ASSERT_EQ(Board::Player::E, b(15, 1));
+
+	ASSERT_TRUE(++it == f.end());
+
+	std::remove(path.c_str());
+}
+
+TEST(GameRecord, RejectsBadFiles) {
+	ASSERT_THROW(GameRecordFile(testing::TempDir() + "con4_no_such_records.bin"), std::runtime_error);
+
+	std::string path = tempRecords();
+	{
+		std::ofstream out(path, std::ios::binary);
+		out << "C4BK, not records";
+	}
+	ASSERT_THROW(GameRecordFile f(path), std::runtime_error);
+
+	{
+		GameRecordWriter w(path);
+		w.begin(7, 6, "a", "b");
+		for(size_t i = 0; i < 7; i++) {
+			w.move(3);
+		}
+		w.end(Board::Player::NONE);
+	}
+	{
+		//column 3 overflows
+		GameRecordFile f(path);
+		ASSERT_THROW((*f.begin()).replay(), std::runtime_error);
+	}
+
+	//cut the last record short
+	std::ifstream in(path, std::ios::binary);
+	std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	in.close();
+	{
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		out.write(data.data(), data.size() - 1);
+	}
+	GameRecordFile f(path);
+	ASSERT_THROW(f.begin(), std::runtime_error);
+
+	std::remove(path.c_str());
+}
+
+TEST(Game, RecordNeedsEmptyBoard) {
+	std::string path = tempRecords();
+	GameRecordWriter w(path);
+
+	Board b(7, 6);
+	b.put(Board::Player::P1, 3);
+	Game g(b, std::unique_ptr<Player>(new RandomPlayer()), std::unique_ptr<Player>(new RandomPlayer()));
+	ASSERT_THROW(g.record(w, "a", "b"), std::invalid_argument);
+
+	std::remove(path.c_str());
+}
@@ -0,0 +1,120 @@
+#include "Rollout.hpp"
+#include "Random.hpp"
+#include "BitBoard.hpp"
+#include "Board.hpp"
+#include "FixedBoard.hpp"
+#include "WideBitBoard.hpp"
+#include <gtest/gtest.h>
+
+#include <vector>
+
+TEST(XorShift, BelowIsInRangeAndSpread) {
+	XorShift g(1);
+	std::vector<int> counts(7, 0);
+
+	for(int i = 0; i < 70000; i++) {
+		uint32_t r = g.below(7);
+		ASSERT_LT(r, 7u);
+		counts[r]++;
+	}
+
+	for(int c : counts) {
+		EXPECT_NEAR(10000, c, 500);
+	}
+
+	XorShift a(5), b(5), c(6);
+	ASSERT_EQ(a(), b());
+	ASSERT_NE(a(), c());
+}
+
+template<class B>
+static void checkRollouts(B start) {
+	XorShift g(42);
+
+	for(int i = 0; i < 200; i++) {
+		B b(start);
+		Board::Player w = rollout(b, Board::Player::P1, g);
+
+		ASSERT_TRUE(b.isGameOver());
+		ASSERT_EQ(b.winner(), w);
+		if(w == Board::Player::E) {
+			ASSERT_TRUE(b.isFull());
+		}
+	}
+}
+
+TEST(Rollout, EndsGames) {
+	checkRollouts(Board(7, 6));
+	checkRollouts(Board(10, 9));
+	checkRollouts(FixedBoard<7, 6>());
+	checkRollouts(BasicWideBitBoard<3>(12, 10));
+	checkRollouts(BitBoard(7, 6));
+	checkRollouts(BitBoard(4, 4));
+}
+
+TEST(Rollout, ScoresFromPointOfView) {
+	//P1 is to move and a piece away from four in column 0
+	Board b(7, 6);
+	b.put(Board::Player::P1, 0);
+	b.put(Board::Player::P2, 2);
+	b.put(Board::Player::P1, 0);
+	b.put(Board::Player::P2, 4);
+	b.put(Board::Player::P1, 0);
+	b.put(Board::Player::P2, 6);
+
+	XorShift g1(3), g2(3);
+	int p1 = rollouts(b, Board::Player::P1, Board::Player::P1, 2000, g1);
+	int p2 = rollouts(b, Board::Player::P2, Board::Player::P1, 2000, g2);
+	ASSERT_GT(p1, 0);
+	ASSERT_EQ(-p1, p2);
+
+	//both kernels pick the k-th playable column from the left, so the
+	//same seed plays the same games
+	XorShift g3(3);
+	ASSERT_EQ(p1, rollouts(BitBoard(b), Board::Player::P1, Board::Player::P1, 2000, g3));
+
+	//and the same for a board picked at runtime
+	XorShift g4(3);
+	ASSERT_EQ(p1, boardRollouts(b, Board::Player::P1, Board::Player::P1, 2000, g4));
+
+	Board big(11, 6);
+	big.put(Board::Player::P1, 5);
+	XorShift g5(3), g6(3);
+	ASSERT_EQ(rollouts(big, Board::Player::P1, Board::Player::P2, 500, g5),
+	          boardRollouts(big, Board::Player::P1, Board::Player::P2, 500, g6));
+}
+
+TEST(Rollout, TacticalTakesWinsAndBlocks) {
+	//P1 is a piece away from four in column 0
+	BitBoard b(7, 6);
+	b.put(Board::Player::P1, 0);
+	b.put(Board::Player::P2, 2);
+	b.put(Board::Player::P1, 0);
+	b.put(Board::Player::P2, 4);
+	b.put(Board::Player::P1, 0);
+
+	XorShift g(9);
+	TacticalRollout policy(b);
+	for(int i = 0; i < 200; i++) {
+		BitBoard sim(b);
+		Board::Player w = policy(sim, Board::Player::P2, g);
+		ASSERT_EQ(Board::Player::P2, sim(0, 3));
+		ASSERT_EQ(sim.winner(), w);
+		ASSERT_TRUE(sim.isGameOver());
+	}
+
+	b.put(Board::Player::P2, 6);
+	ASSERT_EQ(200, tacticalRollouts(b, Board::Player::P1, Board::Player::P1, 200, g));
+	ASSERT_EQ(-200, tacticalRollouts(b, Board::Player::P2, Board::Player::P1, 200, g));
+
+	//and plays whole games to the end from anywhere
+	for(int i = 0; i < 200; i++) {
+		BitBoard sim(7, 6);
+		Board::Player w = policy(sim, Board::Player::P1, g);
+		ASSERT_TRUE(sim.isGameOver());
+		ASSERT_EQ(sim.winner(), w);
+		if(w == Board::Player::E) {
+			ASSERT_TRUE(sim.isFull());
+		}
+	}
+}
@@ -0,0 +1,97 @@
+#include "AnalysisServer.hpp"
+#include <gtest/gtest.h>
+
+#include <future>
+#include <sstream>
+#include <string>
+#include <vector>
+
+TEST(AnalysisServer, Requests) {
+	AnalysisServer s;
+
+	ASSERT_EQ("1 error illegal move 7", s.handle("1 7x6 7 10"));
+	ASSERT_EQ("2 error illegal move 3", s.handle("2 4x4 33333 10"));
+	ASSERT_EQ("3 error game over", s.handle("3 7x6 0101010 10"));
+	ASSERT_EQ("4 error bad board size", s.handle("4 7by6 - 10"));
+	ASSERT_EQ("5 error bad time budget", s.handle("5 7x6 - 0"));
+	ASSERT_EQ("6 error expected ID WxH MOVES MS", s.handle("6 7x6 -"));
+
+	//P1 has three in column 0 and wins on the spot, small boards are
+	//left to the solver
+	ASSERT_EQ("7 0 1.000 solver", s.handle("7 5x4 010101 10"));
+	ASSERT_EQ("8 0 1.000 search", s.handle("8 7x6 010101 10"));
+
+	std::string r = s.handle("a 7x6 - 10");
+	ASSERT_EQ(0u, r.find("a "));
+	ASSERT_NE(std::string::npos, r.find(" search"));
+}
+
+TEST(AnalysisServer, SearcherErrorsAreAnswered) {
+	//a table with no buckets fails to build
+	AnalysisServer s("", 0);
+	std::string r = s.handle("1 7x6 - 10");
+	ASSERT_EQ(0u, r.find("1 error "));
+	ASSERT_EQ(0u, s.submit("2 7x6 - 10").get().find("2 error "));
+}
+
+TEST(AnalysisServer, MixedBoardSizes) {
+	//the same stones on three sizes, P2 has three in column 0. P1 has
+	//to block it where the column has room, on 10x3 it's already full.
+	//Searching the small board in between must not change the answers.
+	AnalysisServer s;
+	for(size_t i = 0; i < 3; i++) {
+		ASSERT_EQ(0u, s.handle("a 10x3 306010 20").find("a "));
+		std::string tall = s.handle("b 10x6 306010 20");
+		std::string mid = s.handle("c 10x4 306010 20");
+
+		//a fresh searcher agrees on the move
+		AnalysisServer fresh;
+		ASSERT_EQ(0u, tall.find("b 0 ")) << tall;
+		ASSERT_EQ(0u, fresh.handle("b 10x6 306010 20").find("b 0 "));
+		ASSERT_EQ(0u, mid.find("c 0 ")) << mid;
+		ASSERT_EQ(0u, fresh.handle("c 10x4 306010 20").find("c 0 "));
+	}
+}
+
+TEST(AnalysisServer, BatchesInOrder) {
+	AnalysisServer s;
+
+	std::vector<std::string> lines;
+	for(size_t i = 0; i < 8; i++) {
+		lines.push_back(std::to_string(i) + " 5x4 010101 10");
+	}
+
+	std::vector<std::string> replies = s.handle(lines);
+	ASSERT_EQ(lines.size(), replies.size());
+	for(size_t i = 0; i < replies.size(); i++) {
+		ASSERT_EQ(std::to_string(i) + " 0 1.000 solver", replies[i]);
+	}
+
+	std::vector<std::future<std::string>> futures;
+	for(size_t i = 0; i < 8; i++) {
+		futures.push_back(s.submit(std::to_string(i) + " 5x4 - 5"));
+	}
+	for(size_t i = 0; i < futures.size(); i++) {
+		ASSERT_EQ(0u, futures[i].get().find(std::to_string(i) + " "));
+	}
+}
+
+TEST(AnalysisServer, Serve) {
+	AnalysisServer s;
+
+	std::istringstream in("1 5x4 010101 10\n\n2 7x6 9 10\n3 5x4 - 5\n");
+	std::ostringstream out;
+	s.serve(in, out);
+
+	std::istringstream replies(out.str());
+	std::string line;
+	std::vector<std::string> lines;
+	while(std::getline(replies, line)) {
+		lines.push_back(line);
+	}
+
+	ASSERT_EQ(3u, lines.size());
+	ASSERT_EQ("1 0 1.000 solver", lines[0]);
+	ASSERT_EQ("2 error illegal move 9", lines[1]);
+	ASSERT_EQ(0u, lines[2].find("3 "));
+}
@@ -0,0 +1,115 @@
+#include "Solver.hpp"
+#include "BitBoard.hpp"
+#include "Board.hpp"
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <random>
+
+//plain negamax over every line of play, same scoring as Solver
+static int referenceScore(BitBoard& b, Board::Player p, int stones) {
+	const int cells = b.width() * b.height();
+	Board::Player o = p == Board::Player::P1 ? Board::Player::P2 : Board::Player::P1;
+
+	int best = -cells;
+	bool any = false;
+	for(size_t x = 0; x < b.width(); x++) {
+		if(b.isColumnFull(x)) {
+			continue;
+		}
+		any = true;
+
+		size_t y = b.put(p, x);
+		int s = causedWin(b, x, y) ? (cells + 1 - stones) / 2 :
+		                             -referenceScore(b, o, stones + 1);
+		b.unput(x);
+
+		best = std::max(best, s);
+	}
+
+	return any ? best : 0;
+}
+
+//random positions with the given number of empty cells that aren't over yet
+static void compareWithReference(size_t width, size_t height, int empty, unsigned seed) {
+	std::default_random_engine g(seed);
+	Solver s(1);
+
+	for(int i = 0; i < 20; i++) {
+		BitBoard b(width, height);
+		Board::Player p = Board::Player::P1;
+		int stones = 0;
+
+		while(stones < int(width * height) - empty) {
+			size_t x = std::uniform_int_distribution<size_t>(0, width - 1)(g);
+			if(b.isColumnFull(x)) {
+				continue;
+			}
+
+			size_t y = b.put(p, x);
+			if(causedWin(b, x, y)) {
+				b.reset();
+				p = Board::Player::P1;
+				stones = 0;
+				continue;
+			}
+
+			stones++;
+			p = p == Board::Player::P1 ? Board::Player::P2 : Board::Player::P1;
+		}
+
+		int expected = referenceScore(b, p, stones);
+		Solver::Result r = s.solve(b, p);
+		ASSERT_EQ(r.score, expected) << b.toString();
+
+		//the move has to achieve the score
+		ASSERT_FALSE(b.isColumnFull(r.move));
+		Board::Player o = p == Board::Player::P1 ? Board::Player::P2 : Board::Player::P1;
+		size_t y = b.put(p, r.move);
+		int after = causedWin(b, r.move, y) ? (int(width * height) + 1 - stones) / 2 :
+		                                      -referenceScore(b, o, stones + 1);
+		EXPECT_EQ(after, expected) << b.toString();
+	}
+}
+
+TEST(SolverTest, MatchesReference4x4) {
+	compareWithReference(4, 4, 10, 1);
+}
+
+TEST(SolverTest, MatchesReference5x4) {
+	compareWithReference(5, 4, 9, 2);
+}
+
+TEST(SolverTest, MatchesReference7x6) {
+	compareWithReference(7, 6, 9, 3);
+}
+
+TEST(SolverTest, ImmediateWin) {
+	BitBoard b(7, 6);
+	b.put(Board::Player::P1, 0);
+	b.put(Board::Player::P1, 1);
+	b.put(Board::Player::P1, 2);
+	b.put(Board::Player::P2, 0);
+	b.put(Board::Player::P2, 1);
+	b.put(Board::Player::P2, 2);
+
+	Solver s(1);
+	Solver::Result r = s.solve(b, Board::Player::P1);
+	EXPECT_EQ(r.move, 3);
+	EXPECT_EQ(r.score, (42 + 1 - 6) / 2);
+}
+
+TEST(SolverTest, EndgameHandover) {
+	Board b(7, 6);
+	std::unique_ptr<Solver> s;
+	size_t move;
+
+	EXPECT_FALSE(solveEndgame(s, b, Board::Player::P1, 12, move));
+	EXPECT_EQ(emptyCells(b), 42);
+
+	b.put(Board::Player::P2, 3);
+	b.put(Board::Player::P2, 3);
+	b.put(Board::Player::P2, 3);
+	EXPECT_TRUE(solveEndgame(s, b, Board::Player::P1, 42, move));
+	EXPECT_EQ(move, 3);
+}
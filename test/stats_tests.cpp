@@ -0,0 +1,191 @@
+#include "SearchStats.hpp"
+#include "Confidence.hpp"
+#include "HybridPlayer.hpp"
+#include "MCTSPlayer.hpp"
+#include "MonteCarloPlayer.hpp"
+#include "RandomPlayer.hpp"
+#include "Tournament.hpp"
+#include "Board.hpp"
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+static uint64_t sum(const std::vector<uint64_t>& v) {
+	return std::accumulate(v.begin(), v.end(), uint64_t(0));
+}
+
+TEST(SearchStats, FilledByEveryAIPlayer) {
+	Board b(7, 6);
+	b.put(Board::Player::P1, 3);
+
+	RandomPlayer random;
+	ASSERT_EQ(nullptr, random.lastStats());
+
+	MonteCarloPlayer mc(7000);
+	size_t move = mc.makeMove(b, Board::Player::P2);
+	const SearchStats* s = mc.lastStats();
+	ASSERT_NE(nullptr, s);
+	EXPECT_EQ(move, s->move);
+	EXPECT_EQ(7000u, s->counters.playouts);
+	EXPECT_EQ(7u, s->rootPlayouts.size());
+	EXPECT_EQ(s->counters.playouts, sum(s->rootPlayouts));
+	EXPECT_GT(s->totalSeconds, 0.0);
+	EXPECT_FALSE(s->solved);
+
+	HybridPlayer hybrid(7000, 4);
+	move = hybrid.makeMove(b, Board::Player::P2);
+	s = hybrid.lastStats();
+	EXPECT_EQ(move, s->move);
+	EXPECT_EQ(4u, s->depth);
+	EXPECT_GT(s->counters.nodes, 7u);
+	EXPECT_GT(s->counters.cutoffs, 0u);
+	EXPECT_GT(s->counters.ttProbes, 0u);
+	EXPECT_EQ(s->counters.playouts, sum(s->rootPlayouts));
+
+	HybridPlayer timed((std::chrono::milliseconds(30)));
+	timed.makeMove(b, Board::Player::P2);
+	s = timed.lastStats();
+	EXPECT_GT(s->depth, 0u);
+	EXPECT_GT(s->counters.playouts, 0u);
+	EXPECT_EQ(s->counters.playouts, sum(s->rootPlayouts));
+
+	MCTSPlayer mcts(2000);
+	move = mcts.makeMove(b, Board::Player::P2);
+	s = mcts.lastStats();
+	EXPECT_EQ(move, s->move);
+	EXPECT_EQ(2000u, s->counters.playouts);
+	EXPECT_GT(s->counters.nodes, 0u);
+}
+
+TEST(SearchStats, Solver) {
+	//fill all but the top two rows
+	Board b(7, 6);
+	const int cols[] = { 0, 1, 0, 1, 2, 3, 2, 3, 4, 5, 4, 5, 6, 0, 6, 0, 1, 2, 1, 2, 3, 4, 3, 4, 5, 6, 5, 6 };
+	Board::Player p = Board::Player::P1;
+	for(int x : cols) {
+		b.put(p, x);
+		p = p == Board::Player::P1 ? Board::Player::P2 : Board::Player::P1;
+	}
+	ASSERT_EQ(Board::Player::E, b.winner());
+
+	MonteCarloPlayer mc(1000);
+	mc.makeMove(b, p);
+
+	const SearchStats* s = mc.lastStats();
+	EXPECT_TRUE(s->solved);
+	EXPECT_GT(s->solverNodes, 0u);
+	EXPECT_EQ(0u, s->counters.playouts);
+}
+
+TEST(SearchStats, HalvingFavoursContenders) {
+	//P2 has to block column 0
+	Board b(7, 6);
+	b.put(Board::Player::P1, 0);
+	b.put(Board::Player::P2, 3);
+	b.put(Board::Player::P1, 0);
+	b.put(Board::Player::P2, 3);
+	b.put(Board::Player::P1, 0);
+
+	MonteCarloPlayer mc(7001);
+	mc.setSolverThreshold(0);
+	mc.setEarlyStop(0);
+	ASSERT_EQ(0u, mc.makeMove(b, Board::Player::P2));
+
+	const SearchStats* s = mc.lastStats();
+	EXPECT_EQ(7001u, sum(s->rootPlayouts));
+	//only the runner-up of the last round keeps up
+	size_t dropped = 0;
+	for(size_t x = 1; x < 7; x++) {
+		EXPECT_GE(s->rootPlayouts[0], s->rootPlayouts[x]);
+		dropped += s->rootPlayouts[0] > 2 * s->rootPlayouts[x];
+	}
+	EXPECT_EQ(5u, dropped);
+
+	mc.setRootAllocation(RootAllocation::UNIFORM);
+	ASSERT_EQ(0u, mc.makeMove(b, Board::Player::P2));
+	EXPECT_EQ(std::vector<uint64_t>(7, 1000), mc.lastStats()->rootPlayouts);
+}
+
+TEST(SearchStats, EarlyStop) {
+	EXPECT_TRUE(std::isinf(hoeffdingRadius(0, 0.01)));
+	EXPECT_GT(hoeffdingRadius(100, 0.01), hoeffdingRadius(400, 0.01));
+	EXPECT_GT(hoeffdingRadius(100, 0.001), hoeffdingRadius(100, 0.01));
+
+	//the shares of every move at every check add up to at most delta
+	double total = 0;
+	for(size_t check = 1; check <= 10000; check++) {
+		total += 7 * checkDelta(0.01, 7, check);
+	}
+	EXPECT_LE(total, 0.01);
+	EXPECT_GT(total, 0.0099);
+
+	EXPECT_TRUE(separated({ { 0.5f, 0.2f }, { -0.2f, 0.4f } }));
+	EXPECT_FALSE(separated({ { 0.5f, 0.2f }, { -0.2f, 0.6f } }));
+	EXPECT_TRUE(separated({ { 1.0f / 0.0f, 0 }, { 0.9f, 1.0f / 0.0f } }));
+	EXPECT_TRUE(separated({ { -0.9f, 1.0f / 0.0f }, { -1.0f / 0.0f, 0 } }));
+
+	//P2 has to block column 0, every other move loses
+	Board b(7, 6);
+	b.put(Board::Player::P1, 0);
+	b.put(Board::Player::P2, 3);
+	b.put(Board::Player::P1, 0);
+	b.put(Board::Player::P2, 3);
+	b.put(Board::Player::P1, 0);
+
+	MonteCarloPlayer mc(100000);
+	mc.setSolverThreshold(0);
+	ASSERT_EQ(0u, mc.makeMove(b, Board::Player::P2));
+	EXPECT_LT(mc.lastStats()->counters.playouts, 20000u);
+
+	//minimax proves the other moves lose, so no rollouts are needed
+	HybridPlayer hybrid(100000, 2);
+	hybrid.setSolverThreshold(0);
+	ASSERT_EQ(0u, hybrid.makeMove(b, Board::Player::P2));
+	EXPECT_EQ(0u, hybrid.lastStats()->counters.playouts);
+
+	hybrid.setEarlyStop(0);
+	ASSERT_EQ(0u, hybrid.makeMove(b, Board::Player::P2));
+	EXPECT_EQ(100000u / 7, hybrid.lastStats()->counters.playouts);
+
+	EXPECT_THROW(mc.setEarlyStop(1), std::invalid_argument);
+}
+
+TEST(SearchStats, Json) {
+	SearchStats s;
+	s.move = 2;
+	s.counters.nodes = 10;
+	s.rootPlayouts = { 1, 2 };
+	s.solved = true;
+
+	std::string j = s.toJson();
+	EXPECT_EQ('{', j.front());
+	EXPECT_EQ('}', j.back());
+	EXPECT_EQ(std::string::npos, j.find('\n'));
+	EXPECT_NE(std::string::npos, j.find("\"move\":2"));
+	EXPECT_NE(std::string::npos, j.find("\"nodes\":10"));
+	EXPECT_NE(std::string::npos, j.find("\"root_playouts\":[1,2]"));
+	EXPECT_NE(std::string::npos, j.find("\"solved\":true"));
+
+	s.clear();
+	EXPECT_EQ(0u, s.counters.nodes);
+	EXPECT_TRUE(s.rootPlayouts.empty());
+}
+
+TEST(SearchStats, TournamentReportsMoves) {
+	Tournament t("mc:500", "random", 5, 4);
+
+	size_t firstMoves = 0;
+	size_t secondMoves = 0;
+	t.run(4, 2, Tournament::Progress(), [&](size_t, size_t, bool first, const SearchStats& s) {
+		(first ? firstMoves : secondMoves)++;
+		EXPECT_GT(s.totalSeconds, 0.0);
+	});
+
+	//only mc keeps stats
+	EXPECT_GT(firstMoves, 0u);
+	EXPECT_EQ(0u, secondMoves);
+}
@@ -0,0 +1,88 @@
+#include "ThreadPool.hpp"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST(ThreadPool, RunsEveryTaskOnce) {
+	ThreadPool pool(4);
+	ASSERT_EQ(4u, pool.size());
+
+	for(size_t n : { 0, 1, 3, 4, 1000 }) {
+		std::vector<std::atomic<int>> runs(n);
+		for(auto& r : runs) {
+			r = 0;
+		}
+
+		pool.parallelFor(n, [&](size_t i) { runs[i]++; });
+
+		for(auto& r : runs) {
+			ASSERT_EQ(1, r.load());
+		}
+	}
+}
+
+TEST(ThreadPool, StealsFromBusyThreads) {
+	ThreadPool pool(4);
+
+	//the caller's own block is slow, the others have to take it over
+	std::mutex m;
+	std::set<std::thread::id> ranSlow;
+	pool.parallelFor(16, [&](size_t i) {
+		if(i < 4) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+			std::lock_guard<std::mutex> lock(m);
+			ranSlow.insert(std::this_thread::get_id());
+		}
+	});
+
+	ASSERT_GT(ranSlow.size(), 1u);
+}
+
+TEST(ThreadPool, RethrowsAndStaysUsable) {
+	ThreadPool pool(3);
+
+	std::atomic<int> ran(0);
+	ASSERT_THROW(pool.parallelFor(10, [&](size_t i) {
+		ran++;
+		if(i == 7) {
+			throw std::runtime_error("task failed");
+		}
+	}), std::runtime_error);
+	ASSERT_EQ(10, ran.load());
+
+	ran = 0;
+	pool.parallelFor(10, [&](size_t) { ran++; });
+	ASSERT_EQ(10, ran.load());
+}
+
+TEST(ThreadPool, NestedAndConcurrentCalls) {
+	ThreadPool pool(4);
+	std::atomic<int> ran(0);
+
+	//inner calls find the pool busy and run inline
+	pool.parallelFor(4, [&](size_t) {
+		pool.parallelFor(5, [&](size_t) { ran++; });
+	});
+	ASSERT_EQ(20, ran.load());
+
+	ran = 0;
+	std::vector<std::thread> callers;
+	for(int t = 0; t < 4; t++) {
+		callers.emplace_back([&]() {
+			for(int k = 0; k < 20; k++) {
+				pool.parallelFor(50, [&](size_t) { ran++; });
+			}
+		});
+	}
+	for(auto& t : callers) {
+		t.join();
+	}
+	ASSERT_EQ(4 * 20 * 50, ran.load());
+}
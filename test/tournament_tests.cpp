@@ -0,0 +1,81 @@
+#include "Tournament.hpp"
+#include "PlayerFactory.hpp"
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <stdexcept>
+
+TEST(PlayerFactory, ParsesSpecs) {
+	ASSERT_TRUE(makePlayer("random") != nullptr);
+	ASSERT_TRUE(makePlayer("mc:100") != nullptr);
+	ASSERT_TRUE(makePlayer("mc:100,random") != nullptr);
+	ASSERT_TRUE(makePlayer("mc:100,random,uniform") != nullptr);
+	ASSERT_TRUE(makePlayer("mc:100,tactical") != nullptr);
+	ASSERT_TRUE(makePlayer("hybrid:100,2") != nullptr);
+	ASSERT_TRUE(makePlayer("hybrid:50ms") != nullptr);
+	ASSERT_TRUE(makePlayer("mcts:100") != nullptr);
+	ASSERT_TRUE(makePlayer("mcts:100,2") != nullptr);
+
+	ASSERT_THROW(makePlayer(""), std::invalid_argument);
+	ASSERT_THROW(makePlayer("random:1"), std::invalid_argument);
+	ASSERT_THROW(makePlayer("mc"), std::invalid_argument);
+	ASSERT_THROW(makePlayer("mc:lots"), std::invalid_argument);
+	ASSERT_THROW(makePlayer("mc:100,clever"), std::invalid_argument);
+	ASSERT_THROW(makePlayer("hybrid:100"), std::invalid_argument);
+	ASSERT_THROW(makePlayer("hybrid:ms"), std::invalid_argument);
+	ASSERT_THROW(makePlayer("book:nofallback"), std::invalid_argument);
+	ASSERT_THROW(makePlayer("alphazero"), std::invalid_argument);
+}
+
+TEST(Tournament, Elo) {
+	TournamentResult even = { 10, 0, 10, 0, 1.0 };
+	EloEstimate e = eloEstimate(even);
+	ASSERT_NEAR(0.0, e.elo, 1e-9);
+	ASSERT_LT(e.low, 0.0);
+	ASSERT_GT(e.high, 0.0);
+	ASSERT_NEAR(-e.low, e.high, 1e-9);
+
+	//a 75% score is the textbook 191 points
+	TournamentResult ahead = { 75, 0, 25, 0, 1.0 };
+	ASSERT_NEAR(190.8, eloEstimate(ahead).elo, 0.1);
+
+	//more games, tighter interval
+	TournamentResult more = { 750, 0, 250, 0, 1.0 };
+	EloEstimate m = eloEstimate(more);
+	ASSERT_LT(m.high - m.low, eloEstimate(ahead).high - eloEstimate(ahead).low);
+
+	TournamentResult perfect = { 20, 0, 0, 0, 1.0 };
+	EloEstimate p = eloEstimate(perfect);
+	ASSERT_TRUE(std::isinf(p.elo));
+	ASSERT_FALSE(std::isinf(p.low));
+	ASSERT_GT(p.low, 0.0);
+}
+
+TEST(Tournament, PlaysEveryGame) {
+	ASSERT_THROW(Tournament("random", "nope"), std::invalid_argument);
+
+	Tournament t("mc:200", "random", 5, 4);
+	size_t calls = 0;
+	TournamentResult r = t.run(30, 3, [&calls](const TournamentResult&) { calls++; });
+
+	ASSERT_EQ(30u, r.games());
+	ASSERT_EQ(30u, calls);
+	ASSERT_GE(r.moves, 30u * 7);
+	ASSERT_GT(r.wins, r.losses);
+}
+
+TEST(Tournament, ConnectK) {
+	ASSERT_THROW(Tournament("random", "random", 7, 6, 1), std::invalid_argument);
+
+	//five in a row on a board too big for a BitBoard, and three on one
+	//that fits, so both rollout paths see other win lengths
+	Tournament five("hybrid:400,2", "random", 9, 7, 5);
+	TournamentResult r = five.run(20, 2);
+	ASSERT_EQ(20u, r.games());
+	ASSERT_GT(r.wins, r.losses);
+
+	Tournament three("mc:400", "random", 7, 6, 3);
+	r = three.run(20, 2);
+	ASSERT_EQ(20u, r.games());
+	ASSERT_GT(r.wins, r.losses);
+}
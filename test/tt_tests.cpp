@@ -0,0 +1,54 @@
+#include "TranspositionTable.hpp"
+#include <gtest/gtest.h>
+
+TEST(TranspositionTableTest, StoreAndProbe) {
+	TranspositionTable tt(1);
+	TranspositionTable::Entry e;
+
+	EXPECT_FALSE(tt.probe(1234, e));
+
+	tt.store(1234, { -1.0f / 0.0f, 5, TranspositionTable::Bound::LOWER, 3 });
+	ASSERT_TRUE(tt.probe(1234, e));
+	EXPECT_EQ(e.value, -1.0f / 0.0f);
+	EXPECT_EQ(e.depth, 5);
+	EXPECT_EQ(e.bound, TranspositionTable::Bound::LOWER);
+	EXPECT_EQ(e.move, 3);
+
+	EXPECT_FALSE(tt.probe(4321, e));
+
+	tt.clear();
+	EXPECT_FALSE(tt.probe(1234, e));
+}
+
+TEST(TranspositionTableTest, KeepsDeeperResult) {
+	TranspositionTable tt(1);
+	TranspositionTable::Entry e;
+
+	tt.store(42, { 0.0f, 6, TranspositionTable::Bound::UPPER, 1 });
+	tt.store(42, { 0.0f, 2, TranspositionTable::Bound::LOWER, 2 });
+	ASSERT_TRUE(tt.probe(42, e));
+	EXPECT_EQ(e.depth, 6);
+
+	//unless it's from an older search
+	tt.newSearch();
+	tt.store(42, { 0.0f, 2, TranspositionTable::Bound::LOWER, 2 });
+	ASSERT_TRUE(tt.probe(42, e));
+	EXPECT_EQ(e.depth, 2);
+}
+
+TEST(TranspositionTableTest, Overfill) {
+	//more positions than entries, the table stays bounded
+	TranspositionTable tt(1);
+	TranspositionTable::Entry e;
+
+	for(uint64_t k = 1; k <= tt.size() + 64; k++) {
+		tt.store(k, { 1.0f, (unsigned char)(k % 32), TranspositionTable::Bound::EXACT, 0 });
+	}
+
+	size_t found = 0;
+	for(uint64_t k = 1; k <= tt.size() + 64; k++) {
+		found += tt.probe(k, e);
+	}
+	EXPECT_LE(found, tt.size());
+	EXPECT_GT(found, tt.size() / 2);
+}
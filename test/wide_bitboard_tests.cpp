@@ -0,0 +1,113 @@
+#include "WideBitBoard.hpp"
+#include "Board.hpp"
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+
+//! Plays random games on Board and on a BasicWideBitBoard side by side,
+//! taking back moves now and then, and checks they agree
+template<size_t N>
+static void matchBoard(size_t width, size_t height, int games) {
+	std::default_random_engine g(width * 100 + height);
+
+	for(int game = 0; game < games; game++) {
+		Board b(width, height);
+		BasicWideBitBoard<N> wb(width, height);
+		Board::Player p = Board::Player::P1;
+
+		while(!b.legalMoves().empty()) {
+			auto& moves = b.legalMoves();
+			size_t x = moves[std::uniform_int_distribution<size_t>(0, moves.size() - 1)(g)];
+
+			ASSERT_EQ(b.put(p, x), wb.put(p, x));
+			ASSERT_EQ(b.winner(), wb.winner());
+			ASSERT_EQ(b.isFull(), wb.isFull());
+			ASSERT_EQ(b.legalMoves().size(), wb.legalMoves().size());
+
+			if(std::uniform_int_distribution<int>(0, 4)(g) == 0) {
+				b.unput(x);
+				wb.unput(x);
+				ASSERT_EQ(b.winner(), wb.winner());
+				continue;
+			}
+
+			if(b.winner() != Board::Player::E) {
+				break;
+			}
+			p = p == Board::Player::P1 ? Board::Player::P2 : Board::Player::P1;
+		}
+
+		BasicWideBitBoard<N> converted(b);
+		ASSERT_EQ(b.toString(), wb.toString());
+		ASSERT_EQ(b.toString(), converted.toString());
+		ASSERT_EQ(b.winner(), converted.winner());
+	}
+}
+
+TEST(WideBitBoardTest, Fits) {
+	ASSERT_TRUE(BasicWideBitBoard<2>::fits(9, 7));
+	ASSERT_FALSE(BasicWideBitBoard<2>::fits(12, 10));
+	ASSERT_TRUE(BasicWideBitBoard<3>::fits(12, 10));
+	ASSERT_TRUE(BasicWideBitBoard<4>::fits(16, 12));
+	ASSERT_FALSE(BasicWideBitBoard<8>::fits(65, 1));
+	ASSERT_FALSE(BasicWideBitBoard<8>::fits(0, 6));
+}
+
+TEST(WideBitBoardTest, MatchesBoard) {
+	matchBoard<2>(9, 7, 300);
+	matchBoard<3>(12, 10, 300);
+	matchBoard<4>(16, 12, 300);
+	matchBoard<8>(24, 20, 100);
+	//too tall to check only around the last move
+	matchBoard<2>(3, 30, 300);
+	//lines of every direction cross word boundaries
+	matchBoard<4>(50, 4, 100);
+}
+
+TEST(WideBitBoardTest, FourAcrossWords) {
+	//columns of a 9x7 board are 8 bits apart, so the bottom row from
+	//column 5 to 8 is bits 40 to 64 and ends in the second word
+	BasicWideBitBoard<2> b(9, 7);
+	for(size_t x = 5; x < 8; x++) {
+		b.put(Board::Player::P2, x);
+		b.put(Board::Player::P1, x);
+		ASSERT_EQ(Board::Player::E, b.winner());
+	}
+	b.put(Board::Player::P2, 8);
+	ASSERT_EQ(Board::Player::P2, b.winner());
+
+	b.unput(8);
+	ASSERT_EQ(Board::Player::E, b.winner());
+
+	//the row above, one word up
+	b.put(Board::Player::P1, 8);
+	b.put(Board::Player::P1, 8);
+	ASSERT_EQ(Board::Player::P1, b.winner());
+}
+
+//! Records the size withWideBitBoard picked
+struct SeenWords {
+	size_t words;
+
+	template<size_t N>
+	void operator()(const BasicWideBitBoard<N>&) {
+		words = N;
+	}
+};
+
+TEST(WideBitBoardTest, RuntimeDispatch) {
+	SeenWords seen = { 0 };
+	ASSERT_TRUE(withWideBitBoard(Board(9, 7), seen));
+	ASSERT_EQ(2u, seen.words);
+	ASSERT_TRUE(withWideBitBoard(Board(12, 10), seen));
+	ASSERT_EQ(3u, seen.words);
+	ASSERT_TRUE(withWideBitBoard(Board(16, 12), seen));
+	ASSERT_EQ(4u, seen.words);
+	ASSERT_TRUE(withWideBitBoard(Board(24, 20), seen));
+	ASSERT_EQ(8u, seen.words);
+
+	seen.words = 0;
+	ASSERT_FALSE(withWideBitBoard(Board(40, 40), seen));
+	ASSERT_EQ(0u, seen.words);
+}
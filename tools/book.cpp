@@ -0,0 +1,157 @@
+#include "BitBoard.hpp"
+#include "Board.hpp"
+#include "HybridPlayer.hpp"
+#include "OpeningBook.hpp"
+#include "Solver.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+struct Position {
+	BitBoard board;
+	Board::Player toMove;
+};
+
+static Board::Player other(Board::Player p) {
+	return p == Board::Player::P1 ? Board::Player::P2 : Board::Player::P1;
+}
+
+//! Collects every position reachable in at most plies moves that isn't
+//! over yet, one per mirror pair
+static void enumerate(BitBoard& b, Board::Player p, size_t plies, std::unordered_set<uint64_t>& seen, std::vector<Position>& out) {
+	bool mirrored;
+	if(!seen.insert(OpeningBook::key(b, p, mirrored)).second) {
+		return;
+	}
+	out.push_back({ b, p });
+
+	if(plies == 0) {
+		return;
+	}
+
+	for(size_t x = 0; x < b.width(); x++) {
+		if(b.isColumnFull(x)) {
+			continue;
+		}
+
+		size_t y = b.put(p, x);
+		if(!causedWin(b, x, y) && !b.isFull()) {
+			enumerate(b, other(p), plies - 1, seen, out);
+		}
+		b.unput(x);
+	}
+}
+
+static Board toBoard(const BitBoard& bb) {
+	Board b(bb.width(), bb.height());
+	for(size_t x = 0; x < bb.width(); x++) {
+		for(size_t y = 0; y < bb.height() && bb(x, y) != Board::Player::E; y++) {
+			b.put(bb(x, y), x);
+		}
+	}
+	return b;
+}
+
+static void usage(const char* self) {
+	std::cerr << "Usage: " << self << " <width> <height> <plies> <output> [maxNodes=2000000] [searchMs=200]\n"
+	          << "Solves every position up to plies moves deep. Positions the solver\n"
+	          << "can't finish within maxNodes get a move from a timed HybridPlayer search." << std::endl;
+}
+
+//! Parses a whole decimal argument into n, false if it isn't one
+static bool number(const char* arg, uint64_t& n) {
+	std::string s = arg;
+	if(s.empty() || s.size() > 18 || s.find_first_not_of("0123456789") != std::string::npos) {
+		return false;
+	}
+
+	n = std::strtoull(arg, nullptr, 10);
+	return true;
+}
+
+int main(int argc, char** argv) {
+	if(argc < 5) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	uint64_t width, height, plies;
+	uint64_t maxNodes = 2000000;
+	uint64_t searchMs = 200;
+	//checked here, HybridPlayer would throw on a bad budget inside a worker
+	if(!number(argv[1], width) || !number(argv[2], height) || !number(argv[3], plies) ||
+	   (argc > 5 && (!number(argv[5], maxNodes) || maxNodes == 0)) ||
+	   (argc > 6 && (!number(argv[6], searchMs) || searchMs == 0 || searchMs > 1000000000))) {
+		usage(argv[0]);
+		return 1;
+	}
+	std::string path = argv[4];
+
+	if(!BitBoard::fits(width, height)) {
+		std::cerr << "Board doesn't fit in a BitBoard" << std::endl;
+		return 1;
+	}
+
+	std::vector<Position> positions;
+	{
+		BitBoard b(width, height);
+		std::unordered_set<uint64_t> seen;
+		enumerate(b, Board::Player::P1, plies, seen, positions);
+	}
+	std::cerr << positions.size() << " positions" << std::endl;
+
+	std::vector<OpeningBook::Entry> entries(positions.size());
+	std::atomic<size_t> next(0);
+	std::atomic<size_t> solved(0);
+
+	auto work = [&]() {
+		Solver solver;
+		HybridPlayer search((std::chrono::milliseconds(searchMs)));
+		search.setSolverThreshold(0);
+
+		for(size_t i; (i = next.fetch_add(1)) < positions.size();) {
+			const Position& pos = positions[i];
+
+			Solver::Result r;
+			int8_t score = OpeningBook::UNKNOWN_SCORE;
+			size_t move;
+			if(solver.trySolve(pos.board, pos.toMove, maxNodes, r)) {
+				score = r.score;
+				move = r.move;
+				solved++;
+			} else {
+				move = search.makeMove(toBoard(pos.board), pos.toMove);
+			}
+
+			bool mirrored;
+			entries[i].key = OpeningBook::key(pos.board, pos.toMove, mirrored);
+			entries[i].score = score;
+			entries[i].move = mirrored ? width - 1 - move : move;
+
+			if((i + 1) % 1000 == 0) {
+				std::cerr << (i + 1) << " / " << positions.size() << std::endl;
+			}
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for(unsigned i = 1; i < std::max(1u, std::thread::hardware_concurrency()); i++) {
+		workers.emplace_back(work);
+	}
+	work();
+	for(auto& t : workers) {
+		t.join();
+	}
+
+	OpeningBook::write(path, width, height, plies, entries);
+	std::cerr << "Wrote " << entries.size() << " positions, " << solved << " solved exactly" << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,55 @@
+#include "AnalysisServer.hpp"
+
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+
+static void usage(const char* self) {
+	std::cerr << "Usage: " << self << " [--book FILE] [--socket PATH] [--tt MEGABYTES]\n"
+	          << "Answers requests of the form \"ID WxH MOVES MS\" with \"ID MOVE SCORE SOURCE\",\n"
+	          << "on stdin/stdout or on a Unix domain socket at PATH. MOVES are the columns\n"
+	          << "played so far (0-9 then a-z), or - for the empty board." << std::endl;
+}
+
+int main(int argc, char** argv) {
+	std::string book;
+	std::string socket;
+	size_t tt = 16;
+
+	for(int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if(i + 1 == argc || (arg != "--book" && arg != "--socket" && arg != "--tt")) {
+			usage(argv[0]);
+			return 1;
+		}
+
+		std::string value = argv[++i];
+		if(arg == "--book") {
+			book = value;
+		} else if(arg == "--socket") {
+			socket = value;
+		} else {
+			bool digits = !value.empty() && value.find_first_not_of("0123456789") == std::string::npos;
+			tt = digits ? std::strtoul(value.c_str(), nullptr, 10) : 0;
+			if(tt == 0) {
+				std::cerr << "--tt takes a positive number of megabytes" << std::endl;
+				return 1;
+			}
+		}
+	}
+
+	try {
+		AnalysisServer server(book, tt);
+		if(socket.empty()) {
+			server.serve(std::cin, std::cout);
+		} else {
+			server.listen(socket);
+		}
+	} catch(const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
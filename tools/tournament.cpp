@@ -0,0 +1,96 @@
+#include "Tournament.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+static void usage(const char* self) {
+	std::cerr << "Usage: " << self << " [--stats FILE] <first> <second> [games=100] [threads=0] [width=7] [height=6] [connect=4]\n"
+	          << "Players are specs such as random, mc:8000, hybrid:8000,5, hybrid:200ms,\n"
+	          << "mcts:8000,2 or book:book.bin,mcts:8000. threads=0 uses every core.\n"
+	          << "connect is the number in a row that wins. Colours alternate, results\n"
+	          << "are from the first player's point of view.\n"
+	          << "--stats writes the search stats of every move to FILE as JSON lines." << std::endl;
+}
+
+static void report(const TournamentResult& r, bool final) {
+	EloEstimate e = eloEstimate(r);
+
+	std::printf("%s%zu games  +%zu =%zu -%zu  score %.3f  elo %+.0f [%+.0f, %+.0f]  %.2f games/s  %.1f moves/s\n",
+	            final ? "" : "  ",
+	            r.games(), r.wins, r.draws, r.losses, r.score(),
+	            e.elo, e.low, e.high,
+	            r.games() / r.seconds, r.moves / r.seconds);
+	std::fflush(stdout);
+}
+
+static std::string jsonEscape(const std::string& s) {
+	std::string r;
+	for(char c : s) {
+		if(c == '"' || c == '\\') {
+			r += '\\';
+		}
+		r += c;
+	}
+	return r;
+}
+
+int main(int argc, char** argv) {
+	std::ofstream statsOut;
+	if(argc > 2 && std::string(argv[1]) == "--stats") {
+		statsOut.open(argv[2]);
+		if(!statsOut) {
+			std::cerr << "Can't write " << argv[2] << std::endl;
+			return 1;
+		}
+
+		argv[2] = argv[0];
+		argv += 2;
+		argc -= 2;
+	}
+
+	if(argc < 3) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	size_t games   = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 100;
+	size_t threads = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 0;
+	size_t width   = argc > 5 ? std::strtoul(argv[5], nullptr, 10) : 7;
+	size_t height  = argc > 6 ? std::strtoul(argv[6], nullptr, 10) : 6;
+	size_t connect = argc > 7 ? std::strtoul(argv[7], nullptr, 10) : 4;
+
+	try {
+		Tournament t(argv[1], argv[2], width, height, connect);
+
+		//a progress line roughly every tenth of the run
+		size_t every = games >= 10 ? games / 10 : 1;
+		auto progress = [every](const TournamentResult& r) {
+			if(r.games() % every == 0) {
+				report(r, false);
+			}
+		};
+
+		const std::string first = jsonEscape(argv[1]);
+		const std::string second = jsonEscape(argv[2]);
+		auto moveStats = [&](size_t game, size_t ply, bool byFirst, const SearchStats& s) {
+			statsOut << "{\"game\":" << game << ",\"ply\":" << ply
+			         << ",\"player\":\"" << (byFirst ? first : second) << "\""
+			         << ",\"stats\":" << s.toJson() << "}\n";
+		};
+
+		TournamentResult r = statsOut.is_open() ? t.run(games, threads, progress, moveStats) :
+		                                          t.run(games, threads, progress);
+
+		report(r, true);
+	} catch(const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		usage(argv[0]);
+		return 1;
+	}
+
+	return 0;
+}